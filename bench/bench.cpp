@@ -0,0 +1,256 @@
+// Micro benchmarks of the solver hot paths
+// Every benchmark runs on a fixed seed board corpus, so the results are comparable across commits
+// The results are written to stdout as JSON lines, one per benchmark and board size
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "representation.hpp"
+#include "optimization.hpp"
+#include "rng.hpp"
+#include "generator.hpp"
+#include "scan.hpp"
+#include "deltas.hpp"
+#include "results.hpp"
+
+using namespace std;
+
+// Every allocation of the process is counted, so that a benchmark can report bytes per operation
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    allocatedBytes += size;
+    if (void* p = malloc(size)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchConfig {
+    int warmupSamples = 2;
+    int minSamples = 5;
+    int maxSamples = 50;
+    double minSampleNs = 1e6; // a sample runs the operation until at least this much time passed
+    double budgetNs = 5e8; // stop taking samples once a benchmark used this much time
+    string filter; // only run benchmarks whose name contains this
+};
+
+struct Benchmark {
+    string name;
+    int maxSize; // larger boards are skipped since the operation is too slow on them
+    // Prepares the board and returns the operation which gets measured
+    function<function<void()>(const Board& board)> setup;
+};
+
+// Value the operations write to, so that the compiler can not drop them
+static volatile long long sink = 0;
+
+// Boards with planted mines, the counts match the mines, so a zero error solution exists
+static Board makeBoard(int size, uint64_t seed) {
+    GeneratorOptions options;
+    options.width = size;
+    options.height = size;
+    options.seed = seed;
+    return generateBoard(options).board;
+}
+
+// The search starts from a coin flip state, the same as lahcFill does by default
+static SolverState randomState(Graph& graph, uint64_t seed) {
+    Rng rng(seed);
+    for (auto& [key, bomb] : graph.bombs) {
+        bomb.armed = rng.below(2);
+    }
+    return buildSolverState(graph);
+}
+
+static vector<Benchmark> benchmarks() {
+    vector<Benchmark> list;
+    list.push_back({"scanBoard", 1 << 30, [](const Board& board) {
+        auto text = make_shared<string>();
+        for (const string& row : board.field) *text += row + "\n";
+        return function<void()>([text]() {
+            ScannedBoard scanned = scanBoard(text->data(), text->size());
+            sink = sink + scanned.view.height;
+        });
+    }});
+    list.push_back({"contentHash", 1 << 30, [](const Board& board) {
+        auto text = make_shared<string>();
+        for (const string& row : board.field) *text += row + "\n";
+        return function<void()>([text]() {
+            sink = sink + contentHash(text->data(), text->size());
+        });
+    }});
+    list.push_back({"fromBoard", 1 << 30, [](const Board& board) {
+        return function<void()>([board]() {
+            Graph graph = fromBoard(board);
+            sink = sink + graph.counts.size();
+        });
+    }});
+    list.push_back({"errorScore", 1 << 30, [](const Board& board) {
+        auto graph = make_shared<Graph>(fromBoard(board));
+        randomState(*graph, 1);
+        return function<void()>([graph]() {
+            sink = sink + errorScore(*graph);
+        });
+    }});
+    list.push_back({"lahcFlipScoreImpact", 1 << 30, [](const Board& board) {
+        auto graph = make_shared<Graph>(fromBoard(board));
+        auto state = make_shared<SolverState>(randomState(*graph, 1));
+        auto index = make_shared<int>(0);
+        return function<void()>([state, index]() {
+            sink = sink + lahcFlipScoreImpact(*state, *index);
+            *index = (*index + 1) % state->bombKeys.size();
+        });
+    }});
+    list.push_back({"flipIndex", 1 << 30, [](const Board& board) {
+        auto graph = make_shared<Graph>(fromBoard(board));
+        auto state = make_shared<SolverState>(randomState(*graph, 1));
+        auto rng = make_shared<Rng>(1);
+        return function<void()>([state, rng]() {
+            sink = sink + flipIndex(*state, *rng);
+        });
+    }});
+    // Full gain recomputation of every bit, once per kernel
+    for (DeltaKernel kernel : {DeltaKernel::Scalar, DeltaKernel::Sse4, DeltaKernel::Avx2}) {
+        if (!deltaKernelSupported(kernel)) continue;
+        list.push_back({string("flipDeltas/") + deltaKernelName(kernel), 1 << 30, [kernel](const Board& board) {
+            auto graph = make_shared<Graph>(fromBoard(board));
+            auto state = make_shared<SolverState>(randomState(*graph, 1));
+            auto deltas = make_shared<vector<int>>(state->bombKeys.size());
+            return function<void()>([state, deltas, kernel]() {
+                flipDeltas(*state, 0, deltas->size(), deltas->data(), kernel);
+                sink = sink + (*deltas)[0];
+            });
+        }});
+        // The same on the 16 bit lookup lahcSearch uses for boards with less than 65535 counts
+        list.push_back({string("flipDeltas16/") + deltaKernelName(kernel), 1 << 30, [kernel](const Board& board) {
+            auto graph = make_shared<Graph>(fromBoard(board));
+            auto state = make_shared<SolverState>(randomState(*graph, 1));
+            auto impacts = make_shared<pmr::vector<uint16_t>>(narrowImpacts<uint16_t>(*state));
+            auto deltas = make_shared<vector<int>>(state->bombKeys.size());
+            return function<void()>([state, impacts, deltas, kernel]() {
+                flipDeltas(*state, impacts->data(), 0, deltas->size(), deltas->data(), kernel);
+                sink = sink + (*deltas)[0];
+            });
+        }});
+    }
+    list.push_back({"applyFlip", 1 << 30, [](const Board& board) {
+        auto graph = make_shared<Graph>(fromBoard(board));
+        auto state = make_shared<SolverState>(randomState(*graph, 1));
+        auto rng = make_shared<Rng>(1);
+        return function<void()>([state, rng]() {
+            applyFlip(*state, rng->below(state->bombKeys.size()));
+        });
+    }});
+    list.push_back({"dumpGraph", 1 << 30, [](const Board& board) {
+        auto graph = make_shared<Graph>(fromBoard(board));
+        return function<void()>([graph]() {
+            ostringstream out;
+            streambuf* old = cout.rdbuf(out.rdbuf());
+            dumpGraph(*graph);
+            cout.rdbuf(old);
+            sink = sink + out.tellp();
+        });
+    }});
+    return list;
+}
+
+static double percentile(const vector<double>& sorted, double p) {
+    size_t index = min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+static void run(const Benchmark& benchmark, int size, const Board& board, const BenchConfig& config) {
+    using clock = chrono::steady_clock;
+    function<void()> operation = benchmark.setup(board);
+    // Find how many operations are needed for a sample to be long enough
+    long long batch = 1;
+    while (true) {
+        auto start = clock::now();
+        for (long long i = 0; i < batch; i++) operation();
+        double elapsed = chrono::duration<double, nano>(clock::now() - start).count();
+        if (elapsed >= config.minSampleNs || batch >= (1LL << 30)) break;
+        batch *= 2;
+    }
+    for (int i = 0; i < config.warmupSamples; i++) {
+        for (long long j = 0; j < batch; j++) operation();
+    }
+    vector<double> samples;
+    // Reserved up front, so only the allocations of the operation are counted
+    samples.reserve(config.maxSamples);
+    double total = 0;
+    size_t bytesBefore = allocatedBytes;
+    while ((int)samples.size() < config.maxSamples) {
+        if ((int)samples.size() >= config.minSamples && total >= config.budgetNs) break;
+        auto start = clock::now();
+        for (long long i = 0; i < batch; i++) operation();
+        double elapsed = chrono::duration<double, nano>(clock::now() - start).count();
+        total += elapsed;
+        samples.push_back(elapsed / batch);
+    }
+    double ops = (double)batch * samples.size();
+    double bytesPerOp = (allocatedBytes - bytesBefore) / ops;
+    sort(samples.begin(), samples.end());
+    double median = percentile(samples, 0.5);
+    cout << "{\"bench\":\"" << benchmark.name << "\""
+         << ",\"size\":" << size
+         << ",\"samples\":" << samples.size()
+         << ",\"batch\":" << batch
+         << ",\"ns_per_op\":" << median
+         << ",\"min\":" << samples.front()
+         << ",\"p90\":" << percentile(samples, 0.9)
+         << ",\"p99\":" << percentile(samples, 0.99)
+         << ",\"ops_per_sec\":" << 1e9 / median
+         << ",\"bytes_per_op\":" << bytesPerOp
+         << "}" << endl;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    vector<int> sizes = {32, 128, 512};
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else if (arg == "--samples" && i + 1 < argc) {
+            config.maxSamples = stoi(argv[++i]);
+            // The percentiles need at least one sample
+            if (config.maxSamples < 1) {
+                cerr << "--samples needs at least 1 sample" << endl;
+                return 1;
+            }
+            config.minSamples = min(config.minSamples, config.maxSamples);
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            // Comma separated list of board sides
+            sizes.clear();
+            stringstream list(argv[++i]);
+            string size;
+            while (getline(list, size, ',')) sizes.push_back(stoi(size));
+        } else {
+            cerr << "Unknown argument: " << arg << endl;
+            return 1;
+        }
+    }
+    for (int size : sizes) {
+        // Fixed seed per size, so every commit measures the same boards
+        Board board = makeBoard(size, 1000 + size);
+        for (const Benchmark& benchmark : benchmarks()) {
+            if (size > benchmark.maxSize) continue;
+            if (!config.filter.empty() && benchmark.name.find(config.filter) == string::npos) continue;
+            run(benchmark, size, board, config);
+        }
+    }
+    return 0;
+}
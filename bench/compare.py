@@ -0,0 +1,33 @@
+import json
+import sys
+
+# Compare two outputs of bin/bench, e.g. of two commits
+# Usage: python3 bench/compare.py before.jsonl after.jsonl
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            result = json.loads(line)
+            results[(result["bench"], result["size"])] = result
+    return results
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: compare.py before.jsonl after.jsonl")
+        sys.exit(1)
+    before = load(sys.argv[1])
+    after = load(sys.argv[2])
+    print(f"{'bench':<24}{'size':>6}{'before ns':>14}{'after ns':>14}{'speedup':>10}{'bytes/op':>14}")
+    for key in sorted(before.keys() & after.keys()):
+        old = before[key]
+        new = after[key]
+        speedup = old["ns_per_op"] / new["ns_per_op"] if new["ns_per_op"] > 0 else float("inf")
+        print(f"{key[0]:<24}{key[1]:>6}{old['ns_per_op']:>14.1f}{new['ns_per_op']:>14.1f}"
+              f"{speedup:>9.2f}x{new['bytes_per_op']:>14.1f}")
+
+if __name__ == "__main__":
+    main()
@@ -2,7 +2,7 @@
 setlocal
 
 set CXX=g++
-set CXXFLAGS=-Wall -O3 -Wextra -std=c++20 -Iinclude
+set CXXFLAGS=-Wall -O3 -Wextra -std=c++20 -Iinclude -pthread
 set SRC_DIR=src
 set OUT=bin\sweeper.exe
 
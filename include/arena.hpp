@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+using namespace std;
+
+// Monotonic memory for one solve
+// Allocations bump a pointer through blocks which come from the heap, deallocate does nothing
+// reset() rewinds to the first block and keeps all of them, so solving the next board of the same size
+// takes no memory from the heap at all
+// The graph, the search state and the scratch buffers of the search all come from the resource of the graph
+// Not thread-safe: code which runs threads on a graph has to allocate everything they need before starting them
+class Arena : public pmr::memory_resource {
+public:
+    // The first block gets allocated on the first allocation
+    explicit Arena(size_t firstBlock = 1 << 16);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena();
+
+    // Everything allocated so far is free again, the blocks are kept
+    // Nothing allocated from the arena may be used afterwards
+    void reset();
+
+    // Bytes handed out since the last reset
+    size_t used() const;
+
+    // Bytes of all blocks
+    size_t reserved() const;
+
+    // How many blocks were taken from the heap since the arena was created
+    size_t heapAllocations() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+    vector<Block> blocks_;
+    size_t current_ = 0; // block the pointer is in
+    size_t offset_ = 0; // bytes of the current block which are taken
+    size_t used_ = 0;
+    size_t nextBlock_;
+    size_t heapAllocations_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+};
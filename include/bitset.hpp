@@ -1,19 +1,27 @@
 #pragma once
 
 #include <cstdint>
-#include <cstddef> 
+#include <cstddef>
 #include <stdexcept>
+#include <memory_resource>
 
+// test and flip skip the bounds check unless NDEBUG is not defined (the debug build),
+// set and at are always checked
+// The words come from the given memory, copies get theirs from the heap like the pmr containers
 class BitSet {
 public:
-    explicit BitSet(size_t nbits);
+    explicit BitSet(size_t nbits, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     // deep copy constructor
     BitSet(const BitSet& other);
 
-    // deep copy assignment
+    // deep copy assignment, reuses the words if the sizes match, keeps the memory of this set
     BitSet& operator=(const BitSet& other);
 
+    // Moves take the words and their memory, the moved from set is empty
+    BitSet(BitSet&& other) noexcept;
+    BitSet& operator=(BitSet&& other) noexcept;
+
     // Destructor
     ~BitSet();
 
@@ -23,12 +31,54 @@ public:
     // Get bit at pos
     bool at(size_t pos) const;
 
+    // Get bit at pos, for hot loops
+    bool test(size_t pos) const {
+#ifndef NDEBUG
+        check(pos);
+#endif
+        return (data_[pos >> 6] >> (pos & 63)) & 1;
+    }
+
+    // Toggle bit at pos, for hot loops
+    void flip(size_t pos) {
+#ifndef NDEBUG
+        check(pos);
+#endif
+        data_[pos >> 6] ^= uint64_t(1) << (pos & 63);
+    }
+
     size_t size() const;
 
+    // Number of set bits
+    size_t count() const;
+
+    // Number of bits which differ from the other set, without building the xor
+    size_t distance(const BitSet& other) const;
+
+    // First bit at or after pos which differs from the other set, size() if there is none
+    // for (size_t i = a.nextDifference(b, 0); i < a.size(); i = a.nextDifference(b, i + 1)) visits every difference
+    size_t nextDifference(const BitSet& other, size_t pos) const;
+
+    // The other set has to have the same size
+    BitSet& operator^=(const BitSet& other);
+    BitSet& operator&=(const BitSet& other);
+    BitSet& operator|=(const BitSet& other);
+
+    bool operator==(const BitSet& other) const;
+
 private:
     size_t nbits_;
     size_t nwords_;
-    uint64_t* data_;
+    uint64_t* data_; // bits past nbits_ in the last word are always 0
+    std::pmr::memory_resource* memory_;
+
+    uint64_t* allocate(size_t nwords);
+    void release();
 
     void check(size_t pos) const;
+    void checkSize(const BitSet& other) const;
 };
+
+BitSet operator^(BitSet a, const BitSet& b);
+BitSet operator&(BitSet a, const BitSet& b);
+BitSet operator|(BitSet a, const BitSet& b);
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "optimization.hpp"
+
+// Small components of the board solved exactly, with a cache of their solutions
+// Bombs which share a count are in the same component, no count sees bombs of two components,
+// so each component can be solved on its own
+// The shape of a component is where its counts and bombs are and the values of the counts,
+// it decides the problem completely, so the same shape always has the same optimal solution
+// Shapes are made canonical under the 8 rotations and mirrorings of the board before they get looked up
+
+struct Component {
+    vector<int> bits; // bitset indices of the bombs
+    vector<int> counts; // indices of the counts which have bombs
+};
+
+// Connected components over the counts, counts without bombs are in none
+vector<Component> findComponents(const SolverState& state);
+
+// Canonical shape of a component and the order of its bits in it
+struct ComponentShape {
+    string key; // the same for every rotation and mirroring of the shape
+    uint64_t hash = 0; // FNV-1a of the key
+    vector<int> bits; // bits of the component in the order the key lists them
+};
+
+ComponentShape canonicalShape(const Graph& graph, const SolverState& state, const Component& component);
+
+struct ComponentCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    size_t bytes = 0; // estimated memory of the entries
+    size_t entries = 0;
+};
+
+// Optimal assignments by canonical shape, the least recently used get evicted once the memory cap is reached
+// Safe to share between threads
+class ComponentCache {
+public:
+    explicit ComponentCache(size_t maxBytes);
+
+    // The assignment of the shape in the order of its bits, false on a miss
+    bool find(const ComponentShape& shape, vector<char>& assignment);
+
+    void insert(const ComponentShape& shape, const vector<char>& assignment);
+
+    ComponentCacheStats stats() const;
+
+private:
+    struct Entry {
+        uint64_t hash;
+        string key;
+        vector<char> assignment;
+    };
+
+    size_t maxBytes_;
+    list<Entry> entries_; // most recently used first
+    unordered_map<uint64_t, list<Entry>::iterator> index_;
+    ComponentCacheStats stats_;
+    mutable mutex mutex_;
+
+    static size_t entryBytes(const Entry& entry);
+};
+
+struct ComponentOptions {
+    int maxBombs = 24; // larger components are left to the search
+    int nodeLimit = 200000; // search nodes per component, a component which needs more is left to the search too
+};
+
+// Solve every small component exactly and move the state to the solutions, cache can be nullptr
+// Returns the bits which are not decided, those of the larger components and of the ones which ran out of nodes
+vector<int> solveComponents(const Graph& graph, SolverState& state, ComponentCache* cache, const ComponentOptions& options = {});
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include "optimization.hpp"
+
+// The flip kernels of the search, generic over the index type of the impact lookup
+// bitsetImpactLookup is int, lahcSearch makes a uint16_t copy for boards with less than 65535 counts,
+// which halves the memory the hot loops stream through
+// The lookups have the same layout for every index type: 8 slots per bit, the largest value means no more counts
+
+// Slots per bit, a cell has at most 8 neighbors
+const int MAX_DEGREE = 8;
+
+// The narrowest index type the search uses for the board
+enum class IndexWidth {Narrow, Wide};
+
+// Narrow if every count index and the sentinel fit into 16 bits
+IndexWidth indexWidthFor(const SolverState& state);
+
+template <typename Index>
+constexpr Index noCount() {
+    return static_cast<Index>(-1);
+}
+
+// Copy of bitsetImpactLookup with the given index type
+template <typename Index>
+pmr::vector<Index> narrowImpacts(const SolverState& state, pmr::memory_resource* memory = pmr::get_default_resource()) {
+    pmr::vector<Index> impacts(state.bitsetImpactLookup.size(), memory);
+    for (size_t i = 0; i < impacts.size(); i++) {
+        impacts[i] = static_cast<Index>(state.bitsetImpactLookup[i]);
+    }
+    return impacts;
+}
+
+// lahcFlipScoreImpact on the given lookup
+template <typename Index>
+inline int flipScoreImpact(const SolverState& state, const Index* impacts, int bit) {
+    const Index* counts = impacts + bit * MAX_DEGREE;
+    const uint8_t* bits = state.impactBits.data() + bit * MAX_DEGREE;
+    int delta = 0;
+    // The table gives the error of the count with and without the bomb, so there is no branching on the values
+    // The slots are packed, so stopping at the first empty one beats going through all 8 (measured)
+    for (int slot = 0; slot < MAX_DEGREE; ++slot) {
+        if (counts[slot] == noCount<Index>()) break;
+        const uint32_t maskState = state.countMasks[counts[slot]];
+        delta += MASK_ERROR[maskState ^ bits[slot]] - MASK_ERROR[maskState];
+    }
+    return delta;
+}
+
+// Toggle the bit in the masks of its counts, without touching the score or the bitset
+template <typename Index>
+inline void flipMasks(SolverState& state, const Index* impacts, int bit) {
+    const Index* counts = impacts + bit * MAX_DEGREE;
+    const uint8_t* bits = state.impactBits.data() + bit * MAX_DEGREE;
+    for (int slot = 0; slot < MAX_DEGREE; ++slot) {
+        if (counts[slot] == noCount<Index>()) break;
+        state.countMasks[counts[slot]] ^= bits[slot];
+    }
+}
+
+// applyFlip on the given lookup
+template <typename Index>
+inline void flipBit(SolverState& state, const Index* impacts, int bit) {
+    state.score += flipScoreImpact(state, impacts, bit);
+    flipMasks(state, impacts, bit);
+    state.current.flip(bit);
+}
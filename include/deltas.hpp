@@ -0,0 +1,23 @@
+#pragma once
+#include "core.hpp"
+
+// Batched flip deltas
+// Computes lahcFlipScoreImpact for a whole range of bits at once,
+// the 8 counts of a bomb are one vector and 8 bombs get summed together with AVX2 (4 with SSE4)
+
+enum class DeltaKernel {Auto, Scalar, Sse4, Avx2};
+
+// deltas[i] = lahcFlipScoreImpact(state, first + i) for i in [0, count)
+void flipDeltas(const SolverState& state, int first, int count, int* deltas, DeltaKernel kernel = DeltaKernel::Auto);
+
+// The same on a lookup from core.hpp, instantiated for int and uint16_t
+template <typename Index>
+void flipDeltas(const SolverState& state, const Index* impacts, int first, int count, int* deltas, DeltaKernel kernel = DeltaKernel::Auto);
+
+// Whether the kernel can run on this CPU, Auto and Scalar always can
+bool deltaKernelSupported(DeltaKernel kernel);
+
+// The kernel Auto picks on this CPU, AVX2 or scalar
+DeltaKernel bestDeltaKernel();
+
+const char* deltaKernelName(DeltaKernel kernel);
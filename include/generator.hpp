@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "representation.hpp"
+
+// Deterministic generator of boards with planted mines
+// Every cell is derived from the seed and its coordinates, so the same options always give the same board
+
+struct GeneratorOptions {
+    int width = 100;
+    int height = 100;
+    uint64_t seed = 1;
+    float density = 0.15f; // chance that a cell is a mine
+    float mask = 0.0f; // chance that a count gets hidden as '.'
+    bool clustered = false; // mines form clusters instead of being spread uniformly
+    float infeasible = 0.0f; // chance that a count gets a wrong value, so the planted solution is not perfect
+};
+
+// Rows are generated one at a time, only three rows of mines are kept in memory
+// row is the input board, solutionRow has the planted mines marked with X
+// Returns the error of the planted solution, 0 unless counts were made infeasible
+int generateRows(const GeneratorOptions& options, const function<void(const string& row, const string& solutionRow)>& emit);
+
+struct GeneratedBoard {
+    Board board;
+    Board solution; // the planted mines are marked with X
+    int plantedError; // error of the planted solution
+};
+
+GeneratedBoard generateBoard(const GeneratorOptions& options);
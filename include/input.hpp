@@ -0,0 +1,71 @@
+#pragma once
+#include <istream>
+#include <string>
+#include "packed.hpp"
+
+// Files which are read without copying, the file gets memory mapped
+class MappedFile {
+public:
+    // Throws if the file can not be read
+    explicit MappedFile(const string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    // Bytes of the file, valid as long as this object lives
+    const char* data() const;
+    size_t size() const;
+
+private:
+    const char* data_;
+    size_t size_;
+    bool mapped_; // false if the file was read into memory instead
+};
+
+// A board as it was read
+// The rows of a text board point into the text, the cells of a packed board are used as they are unpacked
+struct InputBoard {
+    BoardView view{{}, 0, 0}; // rows of a text board, none for a packed board
+    CellPlane plane; // cells of a packed board
+    bool packed = false;
+    int width = 0;
+    int height = 0;
+};
+
+// Board files which are read without copying
+// The rows of a text board point straight into the mapping
+class MappedBoard {
+public:
+    // Map the file and read its board with readInputBoard
+    // Throws if the file can not be read or the board is malformed
+    explicit MappedBoard(const string& path);
+
+    // The board, valid as long as this object lives
+    const InputBoard& board() const;
+
+    // The raw bytes of the board
+    const MappedFile& file() const;
+
+private:
+    MappedFile file_;
+    InputBoard board_;
+};
+
+// Read the whole stream into one buffer, e.g. stdin before it gets scanned
+string readText(istream& in);
+
+// The rows of a text board (checked with scanBoard) or the cells of a packed board
+// The rows point into the data
+InputBoard readInputBoard(const char* data, size_t size);
+
+// Graph of the board, a packed board gets built straight from its cells
+Graph graphOf(const InputBoard& board, pmr::memory_resource* memory = pmr::get_default_resource());
+
+// Classes of the cells of the board
+CellPlane planeOf(const InputBoard& board);
+
+// Rows of the board for the code which works on text
+// A packed board gets turned into text in the given buffer, the rows point into it
+BoardView rowsOf(const InputBoard& board, string& text);
@@ -0,0 +1,46 @@
+#pragma once
+#include "optimization.hpp"
+#include "rng.hpp"
+
+// Large neighborhood search
+// A window of the board gets destroyed (its bombs are freed)
+// and then repaired exactly while everything outside the window stays fixed
+
+// Buffers of the window repair
+// They are only cleared between steps, so once warmed up a step does not allocate
+struct LnsWindow {
+    explicit LnsWindow(pmr::memory_resource* memory = pmr::get_default_resource());
+
+    pmr::vector<int> vars; // bitset indices of the freed bombs
+    pmr::vector<int> varCounts; // 8 slots per freed bomb with its local count indices, -1 means no more counts
+    pmr::vector<int> counts; // global indices of the counts touched by the window
+    pmr::vector<int> countSlot; // global count index -> local count index, -1 if not touched
+    pmr::vector<int> fixedArmed; // armed neighbors of a local count outside of the window
+    pmr::vector<int> armed; // armed neighbors of a local count inside the window so far
+    pmr::vector<int> remaining; // unassigned window neighbors of a local count
+    pmr::vector<char> firstValue; // which value the search tries first for each bomb
+    pmr::vector<char> assignment; // assignment being searched
+    pmr::vector<char> bestAssignment; // best complete assignment found
+    int bestError = 0;
+    int nodes = 0;
+};
+
+// Size the buffers for the largest window of the options, so that not even the first steps allocate
+void lnsReserve(LnsWindow& window, const SolverState& state, const LahcOptions& options);
+
+// Pick a count to center the window on, violated counts are preferred
+int lnsPickCount(const SolverState& state, Rng& rng);
+
+// Destroy the window around the count and repair it with a branch and bound search
+// Returns the change of the total error score if the repair would be applied
+int lnsRepairWindow(
+    const Graph& graph,
+    const SolverState& state,
+    LnsWindow& window,
+    int countIndex,
+    const LahcOptions& options,
+    Rng& rng
+);
+
+// Write the repaired window into the state
+void lnsApplyWindow(SolverState& state, const LnsWindow& window);
@@ -1,5 +1,11 @@
 #pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include "representation.hpp"
+#include "bitset.hpp"
+#include "rng.hpp"
 
 // Calculate how big an error is in the current graph
 int errorScore(const Graph& graph);
@@ -10,10 +16,122 @@ int errorScore(const Graph& graph);
 // Then go through neighboring bombs and arm the unarmed ones until the count is satisfied
 void basicFill(Graph& graph);
 
+// Constructive heuristic which decides the bombs of the tightest counts first
+// A count is tight if it has few ways to place its missing bombs among its undecided neighbors
+// Every decision updates the priorities of the neighboring counts
+void greedyFill(Graph& graph);
+
+
+// Where the search starts from
+enum class InitStrategy {
+    Random, // flip a coin for every bomb
+    Input, // keep the bombs as they are armed in the graph, e.g. by the X marks of the input
+    Basic, // basicFill on top of the armed bombs of the graph
+    Greedy, // greedyFill, ignores how the bombs are armed in the graph
+};
+
+class ComponentCache;
 
 struct LahcOptions {
     int maxIterations = 10000; // Maximum number of iterations
     int scoreMemorySize = 1000; // How many previous scores to remember
+    int lnsPeriod = 0; // Every n-th iteration is a large neighborhood search step, 0 disables it
+    int lnsWindow = 5; // Side length of the window which gets destroyed and repaired
+    int lnsNodeLimit = 100000; // Maximum search nodes the exact window repair may visit
+    InitStrategy init = InitStrategy::Random; // How the bombs get armed before the search
+    uint64_t seed = 0; // Seed of the random generator, the same seed gives the same run
+    uint64_t stream = 0; // Which stream of the seed to use, each thread or replica should use its own
+    int sweepThreads = 0; // Above 0 the search sweeps over the color classes of the bombs with that many threads, see sweep.hpp
+    // Search with 16 bit lookups when the board has few enough counts and the search covers at least a quarter of its bombs
+    bool narrowIndices = true; // off forces the int ones
+    // If set, the small components of the board get solved exactly before the search and their solutions cached, see components.hpp
+    ComponentCache* componentCache = nullptr;
+    // Called with the iteration and the new best score whenever the best score drops, and once at the start
+    function<void(int iteration, int bestScore)> onImprove;
+    // Called when lahcFill starts a phase: "init", "lookups", "components" (with a component cache), "search" and "apply"
+    function<void(const char* phase)> onPhase;
+};
+
+// Arm the bombs of the graph the way the strategy says
+void initialFill(Graph& graph, InitStrategy init, Rng& rng);
+
+// Scale the iteration budget with the number of bombs
+// Each bomb gets iterationsPerBomb iterations and toMemory of all iterations are remembered
+void scaleBudget(LahcOptions& options, int bombCount, int iterationsPerBomb = 50, float toMemory = 0.25f);
+
+// The flat state the search works on
+// Every bomb which touches a count gets a bitset index
+// Counts keep the same index as in graph.counts
+// Everything comes from the memory the state was built with
+struct SolverState {
+    explicit SolverState(pmr::memory_resource* memory = pmr::get_default_resource());
+
+    BitSet current; // armed state of the bombs
+    pmr::unordered_map<i64, int> bombIndexMap; // bomb key -> bitset index
+    pmr::vector<i64> bombKeys; // bitset index -> bomb key
+    // 0-7 are the neighboring bitset indices of count 0, 8-15 of count 1 and so on, -1 means no neighbor
+    pmr::vector<int> countNeighborLookup;
+    // 0-7 are the counts affected by bit 0, 8-15 by bit 1 and so on, -1 means no more counts
+    pmr::vector<int> bitsetImpactLookup;
+    // Same layout as bitsetImpactLookup, the bit of the bomb in the mask of that count, 0 means no count
+    // The bit of a bomb is the slot it has in countNeighborLookup
+    pmr::vector<uint8_t> impactBits;
+    pmr::vector<int> targets; // expected value of each count
+    // target << 8 | mask of the armed neighbors of each count, the index into MASK_ERROR
+    // 32 bits so the vector kernels can gather it directly
+    pmr::vector<uint32_t> countMasks;
+    int score = 0; // error of the current state
 };
 
-void lahcFill(Graph& graph, const LahcOptions& options);
\ No newline at end of file
+// Error of a count for every target and armed neighbor mask, indexed by target << 8 | mask
+// Computed at compile time, 2.5 KiB which stay in L1 during the search
+inline constexpr array<uint8_t, 10 * 256> MASK_ERROR = [] {
+    array<uint8_t, 10 * 256> table{};
+    for (int target = 0; target < 10; target++) {
+        for (int mask = 0; mask < 256; mask++) {
+            const int armed = popcount((unsigned)mask);
+            table[target << 8 | mask] = target > armed ? target - armed : armed - target;
+        }
+    }
+    return table;
+}();
+
+// Error of the count in the current state
+inline int countError(const SolverState& state, int countIndex) {
+    return MASK_ERROR[state.countMasks[countIndex]];
+}
+
+// Armed neighbors of the count in the current state
+inline int armedCount(const SolverState& state, int countIndex) {
+    return popcount((uint8_t)state.countMasks[countIndex]);
+}
+
+// Build the search state from the armed bombs of the graph, from the same memory as the graph
+SolverState buildSolverState(const Graph& graph);
+
+// Calculate the impact of flipping a bit on the total error score
+int lahcFlipScoreImpact(const SolverState& state, int flipIndex);
+
+// Flip a bit and keep the counters and the score up to date
+void applyFlip(SolverState& state, int flipIndex);
+
+// Arm the bombs of the graph according to the solution
+void applySolution(Graph& graph, const SolverState& state, const BitSet& solution);
+
+// Move the state to the given solution
+void restoreSolution(SolverState& state, const BitSet& solution);
+
+// Pick the next bit to flip, weighted by how much flipping it would lower the error
+// If candidates are given, only those bits are considered
+// Allocates the weights on every call, lahcSearch keeps them in a buffer instead
+int flipIndex(const SolverState& state, Rng& rng, const vector<int>* candidates = nullptr);
+
+// Run LAHC starting from the current state, the state ends up in the best solution found
+// If candidates are given, only those bits get flipped
+// The buffers of the search come from the memory of the graph, the loop itself does not allocate
+// Returns how many iterations were run
+int lahcSearch(const Graph& graph, SolverState& state, const LahcOptions& options, Rng& rng, const vector<int>* candidates = nullptr);
+
+// Find a solution with LAHC, returns how many iterations were run
+// The random generator is seeded from the options
+int lahcFill(Graph& graph, const LahcOptions& options);
@@ -0,0 +1,36 @@
+#pragma once
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "representation.hpp"
+#include "packed.hpp"
+
+// Sparse output of a solved graph
+// The size of the output and the time to write it grow with the number of mines, not with the board area
+
+enum class OutputMode {
+    Grid, // the whole board as text
+    Packed, // the whole board as a packed board
+    Mines, // "x y" of every mine
+    Rle, // per row the lengths of the runs without and with mines
+    Diff, // "+ x y" for mines which were not marked in the input, "- x y" for marks which are no mines
+};
+
+// Positions (x, y) of the armed bombs in row-major order
+vector<pair<int, int>> armedCells(const Graph& graph);
+
+// Positions of the mine cells of the plane, row-major
+vector<pair<int, int>> armedCells(const CellPlane& plane);
+
+// One line per mine, row-major
+void writeMines(const Graph& graph, ostream& out);
+void writeMines(const vector<pair<int, int>>& mines, ostream& out);
+
+// One line per row with the alternating lengths of the runs without and with mines, starting without
+// The cells without mines at the end of a row are left out, so a row without mines is an empty line
+void writeRle(const Graph& graph, ostream& out);
+void writeRle(const vector<pair<int, int>>& mines, int height, ostream& out);
+
+// The mines which differ from the given marks (from armedCells of the input), row-major
+void writeDiff(const Graph& graph, const vector<pair<int, int>>& marks, ostream& out);
+void writeDiff(const vector<pair<int, int>>& mines, const vector<pair<int, int>>& marks, ostream& out);
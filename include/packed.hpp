@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "representation.hpp"
+#include "scan.hpp"
+
+// Packed binary boards
+// Every cell is its 4 bit class from scan.hpp, two cells per byte, the low nibble is the left cell
+// Layout, all numbers little endian:
+//   "SWPB", version byte, flags byte, 2 reserved bytes
+//   width and height as uint32, FNV-1a 64 checksum of the packed rows as uint64
+//   the rows, each (width + 1) / 2 bytes,
+//   or with PACKED_COMPRESSED each row is a uint32 length followed by the PackBits encoded row
+
+const uint8_t PACKED_VERSION = 1;
+const uint8_t PACKED_COMPRESSED = 1; // flag of the rows being compressed
+const size_t PACKED_HEADER_SIZE = 24;
+
+// Classes of a whole board
+struct CellPlane {
+    vector<uint8_t> cells; // class of every cell row-major
+    int width = 0;
+    int height = 0;
+};
+
+// FNV-1a 64 of the data, start with FNV_OFFSET or continue from the hash of the data before
+const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size);
+
+// Whether the data starts with the packed magic
+bool isPacked(const char* data, size_t size);
+
+// Classes of the scanned text, the board has to be scanned with classify
+CellPlane planeOf(const ScannedBoard& board);
+
+// Classes of the solved graph, armed bombs are mines and the rest unknown
+CellPlane planeOf(const Graph& graph);
+
+// Classes of the rows, X is a mine and everything which is not a count unknown
+CellPlane planeOf(const BoardView& board);
+
+// Text of the plane, every row ends with a newline
+string planeText(const CellPlane& plane);
+
+// Build the graph straight from the classes, the same graph fromBoard builds from the text of the plane
+Graph fromPlane(const CellPlane& plane, pmr::memory_resource* memory = pmr::get_default_resource());
+
+string packPlane(const CellPlane& plane, bool compress);
+
+// Throws runtime_error if the data is truncated, has a malformed cell or header or the checksum does not match
+CellPlane unpackPlane(const char* data, size_t size);
+
+// Switch the standard stream to binary, only does something on Windows
+void binaryStream(FILE* file);
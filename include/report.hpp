@@ -0,0 +1,30 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Where the time and the memory of a run go, phase by phase
+
+struct PhaseTiming {
+    string name;
+    double wallSeconds = 0;
+    double cpuSeconds = 0;
+    long peakRssKb = 0; // peak resident memory of the process at the end of the phase
+};
+
+struct PhaseReport {
+    vector<PhaseTiming> phases;
+    bool running = false;
+    double wallStart = 0;
+    double cpuStart = 0;
+};
+
+// End the running phase, if there is one, and start the next one
+void phaseStart(PhaseReport& report, const string& name);
+
+// End the running phase
+void phaseEnd(PhaseReport& report);
+
+// Print the phases with their share of the time, and the peak memory per board cell
+void printReport(const PhaseReport& report, long long cells, ostream& out);
@@ -2,6 +2,9 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <memory_resource>
+#include <istream>
+#include <ostream>
 using namespace std;
 #define i64 long long
 
@@ -11,6 +14,13 @@ struct Board {
     int height;
 };
 
+// Rows of a board which are stored somewhere else, e.g. in a memory mapped file
+struct BoardView {
+    vector<const char*> rows; // each row has width cells
+    int width;
+    int height;
+};
+
 struct Bomb {
     int x;
     int y;
@@ -24,16 +34,41 @@ struct Count {
     Bomb* neighbors[8] = {nullptr}; // pointers to neighboring bomb nodes
 };
 
+// The nodes come from one memory resource, the heap unless fromBoard was given an arena
+// Copies go to the heap
 struct Graph {
-    vector<Count> counts; // all count nodes
-    unordered_map<i64, Bomb> bombs; // quick access to bombs
+    pmr::vector<Count> counts; // all count nodes
+    pmr::unordered_map<i64, Bomb> bombs; // quick access to bombs
     int width; // original board width
     int height; // original board height
 };
 
 i64 bombKey(int x, int y);
-// Build a graph from the given board
-Graph fromBoard(const Board& board);
+// View of the rows of the board, valid as long as the board is not changed
+BoardView viewOf(const Board& board);
+
+// Build a graph from the given board, its nodes come from the given memory
+Graph fromBoard(const Board& board, pmr::memory_resource* memory = pmr::get_default_resource());
+Graph fromBoard(const BoardView& board, pmr::memory_resource* memory = pmr::get_default_resource());
+
+// The memory the nodes of the graph come from, the search allocates from it too
+pmr::memory_resource* memoryOf(const Graph& graph);
+
+// Read a board until EOF or a "---" line, empty lines are skipped
+// Throws if the rows have different widths
+Board readBoard(istream& in);
+
+// Arm the bombs which are marked with X on the given board (e.g. a previous result), disarm the rest
+void armFromBoard(Graph& graph, const Board& marks);
+void armFromBoard(Graph& graph, const BoardView& marks);
+
+// Render the graph row-major into one buffer, every row ends with a newline
+string renderGraph(const Graph& graph);
+
+// Write the graph band by band, at most bandRows rows are held in memory at once
+// For boards which are too big to be held twice in memory
+void streamGraph(const Graph& graph, ostream& out, int bandRows);
 
 // Dump a representation of the graph to stdout
+// Big boards get streamed in bands instead of rendered at once
 void dumpGraph(const Graph& graph);
@@ -0,0 +1,40 @@
+#pragma once
+#include "optimization.hpp"
+
+// Re-solving of edited boards
+// A session keeps the board, the graph and the search state of the previous solve,
+// so an edit only touches the cells around it and the search continues from the previous solution
+
+struct Session {
+    Board board; // the board with all edits applied
+    Graph graph;
+    SolverState state;
+    unordered_map<i64, int> countIndexMap; // count key -> index in graph.counts
+    vector<int> freeBits; // bitset indices which are not used by any bomb
+    vector<int> dirty; // bitset indices around the edits since the last solve
+    Rng rng{0}; // generator of the following solves, seeded from the options of the first one
+};
+
+enum class EditKind {
+    SetCount, // put a count into the cell, or change it
+    Clear, // make the cell unknown
+    ToggleMine, // mark the cell as a mine or remove the mark
+};
+
+struct CellEdit {
+    int x;
+    int y;
+    EditKind kind;
+    unsigned int count = 0; // new value for SetCount
+};
+
+// Solve the board from scratch and keep everything around for later edits
+Session startSession(const Board& board, const LahcOptions& options);
+
+// Apply an edit, only the lookups of the cells around it get updated
+void applyEdit(Session& session, const CellEdit& edit);
+
+// Continue the search from the previous solution
+// First only the bombs around the edits get flipped, then the whole board if that was not enough
+// Returns the error score of the solution
+int resolve(Session& session, const LahcOptions& options);
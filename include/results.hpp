@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "packed.hpp"
+using namespace std;
+
+// Results of whole boards by the hash of their bytes
+// A board which was solved before with the same settings gets answered without building the graph or searching
+// The cache can live in a file: every result gets appended to it, and opening the cache maps the file and replays it,
+// so the results survive restarts
+// Only one process at a time writes the file, it holds a lock on PATH.lock (on Windows there is no lock,
+// so only one process may use the file there); the others read the results from it and keep their own in memory
+// File layout, in the byte order of the machine since the file is a local cache:
+//   "SWRC", version as uint32
+//   the results, each hash, size, width and height of the board, score, iterations, seed, seconds, mine count,
+//   then x and y of every mine as uint32
+
+// Fast non-cryptographic hash in the style of xxHash64, 32 bytes at a time in 4 independent lanes
+// The seed mixes in what else the result depends on, e.g. the settings of the solve
+uint64_t contentHash(const char* data, size_t size, uint64_t seed = 0);
+
+// A board is found by the hash and the size of its bytes and its dimensions
+struct ResultKey {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    int width = 0;
+    int height = 0;
+};
+
+ResultKey resultKey(const char* data, size_t size, int width, int height, uint64_t settings);
+
+struct CachedResult {
+    int score = 0;
+    long long iterations = 0;
+    uint64_t seed = 0; // seed of the solve which produced the result
+    double seconds = 0; // how long that solve took
+    vector<pair<int, int>> mines; // row-major
+};
+
+struct ResultCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    size_t bytes = 0; // estimated memory of the entries
+    size_t entries = 0;
+};
+
+// Whether the mines of the result fit the board: all inside of it and none on a count
+// One which does not belongs to another board with the same hash or comes from a damaged file
+bool resultFits(const CachedResult& result, const CellPlane& board);
+
+// Bounded LRU of results, the least recently used get evicted once the memory cap is reached
+class ResultCache {
+public:
+    // An empty path keeps the results in memory only
+    // If another process writes the file, its results are read but the new ones stay in memory
+    // Throws runtime_error if the file exists but is no result cache
+    explicit ResultCache(size_t maxBytes, const string& path = "");
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    ~ResultCache();
+
+    // The cached result, valid until the next insert, nullptr on a miss
+    const CachedResult* find(const ResultKey& key);
+
+    // Drop a found result which does not fit its board, its lookup counts as a miss
+    void drop(const ResultKey& key);
+
+    // Also appends the result to the file
+    // Throws runtime_error if the file could not be appended to or rewritten, the result is cached in memory anyway
+    void insert(const ResultKey& key, const CachedResult& result);
+
+    // Keep the new results in memory only, e.g. after writing the file failed
+    void stopWriting();
+
+    // True if the file is read but not written, because another process writes it
+    bool readOnly() const;
+
+    ResultCacheStats stats() const;
+
+private:
+    struct Entry {
+        ResultKey key;
+        CachedResult result;
+    };
+
+    size_t maxBytes_;
+    string path_;
+    ofstream log_; // the file, opened for appending
+    int lockFd_ = -1; // PATH.lock, locked as long as this process writes the file
+    bool readOnly_ = false;
+    size_t logBytes_ = 0; // size of the file
+    size_t liveBytes_ = 0; // what the file would have with only the cached results
+    list<Entry> entries_; // most recently used first
+    unordered_map<uint64_t, list<Entry>::iterator> index_;
+    ResultCacheStats stats_;
+
+    // Put the entry into memory, replacing one with the same hash, and evict down to the cap
+    void store(Entry entry);
+    void evict(list<Entry>::iterator it);
+    void load();
+    // Rewrite the file with only the cached results, oldest first, so a replay gives the same order
+    void compact();
+
+    static size_t entryBytes(const Entry& entry);
+    static string record(const Entry& entry);
+};
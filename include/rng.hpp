@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** generator
+// Small and fast enough to be called in the hot loop, which mt19937 with its distributions was not
+// Every thread or replica should get its own stream derived from the same seed,
+// so a run can be reproduced from the seed alone
+class Rng {
+public:
+    explicit Rng(uint64_t seed, uint64_t stream = 0) {
+        // splitmix64 spreads the seed and the stream over the whole state
+        uint64_t x = seed ^ (stream * 0xd1342543de82ef95ULL);
+        for (uint64_t& word : s_) {
+            x += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        const uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+    // Integer in [0, bound), bound has to be positive
+    // Multiply and shift instead of modulo, the bias is negligible for the bounds we use
+    uint32_t below(uint32_t bound) {
+        return (uint32_t)(((next() >> 32) * bound) >> 32);
+    }
+
+    // Float in [0, 1)
+    float unit() {
+        return (next() >> 40) * 0x1.0p-24f;
+    }
+
+private:
+    uint64_t s_[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
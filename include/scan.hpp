@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "representation.hpp"
+
+// Vectorized parsing of the board text
+// One pass finds the rows, checks every character and classifies the cells,
+// 16 or 32 bytes at a time when the CPU supports SSE2 or AVX2
+
+// Classes of the cells, a count is stored as its value 0-9
+const uint8_t CELL_MINE = 10;
+const uint8_t CELL_UNKNOWN = 11;
+
+enum class ScanKernel {Auto, Scalar, Sse2, Avx2};
+
+struct ScannedBoard {
+    BoardView view; // rows point into the scanned text
+    vector<uint8_t> cells; // class of every cell row-major, only filled if requested
+};
+
+// Scan the text of a board, same rules as readBoard: empty lines are skipped and a "---" line ends the board
+// A '\r' before a newline is dropped, any other character than 0-9, X and . is an error
+// Throws runtime_error naming the line and column of the first malformed character or uneven row
+ScannedBoard scanBoard(const char* data, size_t size, bool classify = false, ScanKernel kernel = ScanKernel::Auto);
+
+// Whether the kernel can run on this CPU, Auto and Scalar always can
+bool scanKernelSupported(ScanKernel kernel);
+
+// The kernel Auto picks on this CPU
+ScanKernel bestScanKernel();
+
+const char* scanKernelName(ScanKernel kernel);
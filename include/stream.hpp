@@ -0,0 +1,34 @@
+#pragma once
+#include <functional>
+#include <istream>
+#include "optimization.hpp"
+
+// Streaming solver for boards which are too tall to read at once, or which never end
+// The rows get read one at a time and solved in bands of rows below the rows which are already final
+// The last rows of a band are solved again together with the next band, the rows above them are final
+// and get handed out right away, so only a band and the two final rows above it are ever in memory
+// A mine can only change the counts of the row above it, so freezing a row costs nothing but the carried rows
+
+struct StreamOptions {
+    int band = 64; // rows which get read before a band gets solved
+    int carry = 16; // rows at the bottom of a band which are solved again with the next band, less than band
+    int iterationsPerBomb = 50; // budget of each band, see scaleBudget
+    float toMemory = 0.25f;
+};
+
+struct StreamResult {
+    int score = 0; // error of all rows
+    long long iterations = 0; // of all bands
+    int width = 0;
+    int rows = 0;
+    int bands = 0;
+};
+
+// Called with every final row in order, row has X for its mines and . for the other cells which are no count,
+// input is the row as it was read
+using RowSink = function<void(int y, const string& row, const string& input)>;
+
+// Read the board row by row from the stream until its end or a "---" line and solve it in bands
+// Each band gets its own random stream from the seed, sweeps and LNS steps are not used, since they would touch the final rows
+// Throws runtime_error on a malformed row and invalid_argument if the carry does not fit into the band
+StreamResult streamFill(istream& in, const LahcOptions& options, const StreamOptions& stream, const RowSink& emit);
@@ -0,0 +1,32 @@
+#pragma once
+#include "optimization.hpp"
+
+// Parallel sweeps over independent bombs
+// Two bombs which share no count do not change each others flip delta,
+// so the bombs get colored such that bombs of the same color never share a count
+// A sweep step then goes through one color class with several threads at once, without any locks
+
+struct Coloring {
+    explicit Coloring(pmr::memory_resource* memory = pmr::get_default_resource());
+
+    pmr::vector<int> color; // color of every bit
+    // The bits of color c are classBits[classStart[c]] to classBits[classStart[c + 1] - 1], in increasing order
+    pmr::vector<int> classStart;
+    pmr::vector<int> classBits;
+    int colors = 0;
+};
+
+// Greedy coloring of the bits in index order, each bit gets the lowest color none of its neighbors has
+// A bomb shares counts with at most 24 others, so there are at most 25 colors (about 9 on real boards)
+// If bits are given, only those get colored, the others keep color -1 and are in no class
+Coloring colorBits(const SolverState& state, const vector<int>* bits = nullptr);
+
+// LAHC where a move is a sweep over one color class instead of a single flip
+// Every thread proposes flips for its part of the class: improving ones, half of the neutral ones
+// and on average one worsening one per class
+// The worsening flips are then accepted or undone together, like a single flip of LAHC
+// The iteration budget counts the evaluated bits, the score memory gets scaled to moves the same way
+// The same seed and thread count give the same result
+// Only the bits of the classes get flipped
+// Returns how many bits were evaluated
+int sweepSearch(const Graph& graph, SolverState& state, const Coloring& coloring, const LahcOptions& options, Rng& rng);
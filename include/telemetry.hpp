@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <string>
+using namespace std;
+
+// Opt-in telemetry of the search
+// Only compiled in with -DSWEEPER_TELEMETRY (make TELEMETRY=1),
+// otherwise the macros below expand to nothing and the hot loop stays untouched
+// Every thread counts into its own counters, they get published and summed up only on snapshots and when the thread exits
+
+struct TelemetryCounters {
+    uint64_t iterations = 0;
+    uint64_t accepted = 0; // moves which got accepted, including the neutral ones
+    uint64_t rejected = 0;
+    uint64_t neutral = 0; // accepted moves which did not change the score
+    uint64_t improvements = 0; // how often the best score dropped
+    uint64_t lnsSteps = 0;
+    uint64_t selectNs = 0; // time spent choosing the moves
+    uint64_t deltaNs = 0; // time spent evaluating the moves
+    int bestScore = -1; // best score of the latest search, -1 if unknown
+};
+
+// Snapshots go to stderr for "-", otherwise they get appended to the file as JSON lines, an empty path turns them off
+// A thread writes a snapshot every snapshotEvery iterations and when a search ends
+// Returns false if the file could not be opened, no snapshots get written then
+bool telemetryConfigure(const string& path, uint64_t snapshotEvery);
+
+// True if the telemetry was compiled in
+bool telemetryCompiled();
+
+// Counters of the calling thread
+TelemetryCounters& telemetryLocal();
+
+// Publish the counters of the calling thread and write a snapshot of all threads
+void telemetrySnapshot(const char* event);
+
+// Publish the counters of the calling thread and write a snapshot if it is time for one
+void telemetryTick();
+
+// Sum of the latest published counters of all threads
+TelemetryCounters telemetryTotal();
+
+// Monotonic nanoseconds
+uint64_t telemetryNow();
+
+#ifdef SWEEPER_TELEMETRY
+#define TELEMETRY_ADD(field, amount) (telemetryLocal().field += (amount))
+#define TELEMETRY_SET(field, value) (telemetryLocal().field = (value))
+#define TELEMETRY_TIMESTAMP(name) const uint64_t name = telemetryNow()
+#define TELEMETRY_TICK() telemetryTick()
+#define TELEMETRY_SNAPSHOT(event) telemetrySnapshot(event)
+#else
+#define TELEMETRY_ADD(field, amount) ((void)0)
+#define TELEMETRY_SET(field, value) ((void)0)
+#define TELEMETRY_TIMESTAMP(name) ((void)0)
+#define TELEMETRY_TICK() ((void)0)
+#define TELEMETRY_SNAPSHOT(event) ((void)0)
+#endif
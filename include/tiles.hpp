@@ -0,0 +1,35 @@
+#pragma once
+#include "optimization.hpp"
+#include "packed.hpp"
+
+// Domain decomposition for boards which are too large for one search
+// The board gets cut into tiles, every tile is solved on its own together with a margin of overlap around it,
+// and only the interior of each tile is kept
+// A repair pass then frees the bombs around the violated counts along the seams between the tiles
+// and searches only over those, with everything else fixed
+// Every worker builds its tiles in its own arena, so the memory per worker is bounded by the tile size
+
+struct TileOptions {
+    int size = 64; // side of the interior of a tile
+    int overlap = 16; // cells around the interior which get solved along, but are thrown away, less measured clearly worse
+    int seam = 2; // violated counts up to this far from a seam get repaired, freeing the bombs up to this far from them, 0 repairs nothing
+    int threads = 0; // workers, 0 uses every core
+    int iterationsPerBomb = 50; // budget of each tile and each repair, see scaleBudget
+    float toMemory = 0.25f;
+};
+
+struct TiledResult {
+    CellPlane plane; // the input with the mines of the solution, cells which are no count are mines or unknown
+    int score = 0; // error of the solution
+    long long iterations = 0; // of all tiles and repairs
+    int tiles = 0;
+    int repairs = 0; // seam pieces which had violated counts
+};
+
+// Error of a plane, the same as errorScore on the graph of the plane
+int planeErrorScore(const CellPlane& plane);
+
+// Solve the board tile by tile with the given options, any engine and init strategy works
+// Each tile and repair gets its own random stream from the seed, so the result does not depend on the thread count
+// Throws invalid_argument if the tiles are too small for the seam
+TiledResult tiledFill(const BoardView& board, const LahcOptions& options, const TileOptions& tiles);
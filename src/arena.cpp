@@ -0,0 +1,68 @@
+#include "arena.hpp"
+#include <new>
+
+Arena::Arena(size_t firstBlock) : nextBlock_(firstBlock) {}
+
+Arena::~Arena() {
+    for (const Block& block : blocks_) {
+        ::operator delete(block.data);
+    }
+}
+
+void Arena::reset() {
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t Arena::used() const {
+    return used_;
+}
+
+size_t Arena::reserved() const {
+    size_t total = 0;
+    for (const Block& block : blocks_) total += block.size;
+    return total;
+}
+
+size_t Arena::heapAllocations() const {
+    return heapAllocations_;
+}
+
+// Offset of the first address at or after data + offset with the given alignment
+static size_t alignedOffset(const char* data, size_t offset, size_t alignment) {
+    const size_t address = reinterpret_cast<size_t>(data) + offset;
+    return offset + ((alignment - address % alignment) % alignment);
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    // Try the current block, then the blocks which were kept by reset
+    for (; current_ < blocks_.size(); current_++, offset_ = 0) {
+        const Block& block = blocks_[current_];
+        const size_t start = alignedOffset(block.data, offset_, alignment);
+        if (start + bytes <= block.size) {
+            offset_ = start + bytes;
+            used_ += bytes;
+            return block.data + start;
+        }
+    }
+    // Blocks double in size, so a solve takes a logarithmic number of them
+    while (nextBlock_ < bytes + alignment) nextBlock_ *= 2;
+    Block block{static_cast<char*>(::operator new(nextBlock_)), nextBlock_};
+    heapAllocations_++;
+    nextBlock_ *= 2;
+    blocks_.push_back(block);
+    current_ = blocks_.size() - 1;
+    const size_t start = alignedOffset(block.data, 0, alignment);
+    offset_ = start + bytes;
+    used_ += bytes;
+    return block.data + start;
+}
+
+void Arena::do_deallocate(void*, size_t, size_t) {
+    // Freed all at once by reset
+}
+
+bool Arena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -1,31 +1,68 @@
 #include "bitset.hpp"
-#include <cstring> 
+#include <cstring>
+#include <utility>
 
-BitSet::BitSet(size_t nbits)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITSET_POPCNT
+#endif
+
+BitSet::BitSet(size_t nbits, std::pmr::memory_resource* memory)
     : nbits_(nbits),
       nwords_((nbits + 63) / 64),
-      data_(new uint64_t[nwords_]()) {}
+      memory_(memory) {
+    data_ = allocate(nwords_);
+    std::memset(data_, 0, nwords_ * sizeof(uint64_t));
+}
 
 BitSet::BitSet(const BitSet& other)
     : nbits_(other.nbits_),
       nwords_(other.nwords_),
-      data_(new uint64_t[other.nwords_]) {
+      memory_(std::pmr::get_default_resource()) {
+    data_ = allocate(nwords_);
     std::memcpy(data_, other.data_, nwords_ * sizeof(uint64_t));
 }
 
 BitSet& BitSet::operator=(const BitSet& other) {
     if (this != &other) {
-        delete[] data_;
+        if (nwords_ != other.nwords_) {
+            release();
+            nwords_ = other.nwords_;
+            data_ = allocate(nwords_);
+        }
         nbits_ = other.nbits_;
-        nwords_ = other.nwords_;
-        data_ = new uint64_t[nwords_];
         std::memcpy(data_, other.data_, nwords_ * sizeof(uint64_t));
     }
     return *this;
 }
 
+BitSet::BitSet(BitSet&& other) noexcept
+    : nbits_(std::exchange(other.nbits_, 0)),
+      nwords_(std::exchange(other.nwords_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      memory_(other.memory_) {}
+
+BitSet& BitSet::operator=(BitSet&& other) noexcept {
+    if (this != &other) {
+        release();
+        nbits_ = std::exchange(other.nbits_, 0);
+        nwords_ = std::exchange(other.nwords_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        memory_ = other.memory_;
+    }
+    return *this;
+}
+
 BitSet::~BitSet() {
-    delete[] data_;
+    release();
+}
+
+uint64_t* BitSet::allocate(size_t nwords) {
+    return static_cast<uint64_t*>(memory_->allocate(nwords * sizeof(uint64_t), alignof(uint64_t)));
+}
+
+void BitSet::release() {
+    if (data_ != nullptr) memory_->deallocate(data_, nwords_ * sizeof(uint64_t), alignof(uint64_t));
+    data_ = nullptr;
 }
 
 void BitSet::set(size_t pos, bool value) {
@@ -45,6 +82,101 @@ size_t BitSet::size() const {
     return nbits_;
 }
 
+// The baseline x86-64 target has no popcnt instruction, so the loops get compiled twice
+// and the popcnt one is picked at runtime
+template <bool Xor>
+static size_t popcountWords(const uint64_t* a, const uint64_t* b, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += __builtin_popcountll(Xor ? a[i] ^ b[i] : a[i]);
+    }
+    return total;
+}
+
+#ifdef BITSET_POPCNT
+template <bool Xor>
+__attribute__((target("popcnt")))
+static size_t popcountWordsFast(const uint64_t* a, const uint64_t* b, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += __builtin_popcountll(Xor ? a[i] ^ b[i] : a[i]);
+    }
+    return total;
+}
+#endif
+
+template <bool Xor>
+static size_t popcount(const uint64_t* a, const uint64_t* b, size_t n) {
+#ifdef BITSET_POPCNT
+    static const bool fast = __builtin_cpu_supports("popcnt");
+    if (fast) return popcountWordsFast<Xor>(a, b, n);
+#endif
+    return popcountWords<Xor>(a, b, n);
+}
+
+size_t BitSet::count() const {
+    return popcount<false>(data_, data_, nwords_);
+}
+
+size_t BitSet::distance(const BitSet& other) const {
+    checkSize(other);
+    return popcount<true>(data_, other.data_, nwords_);
+}
+
+size_t BitSet::nextDifference(const BitSet& other, size_t pos) const {
+    checkSize(other);
+    if (pos >= nbits_) return nbits_;
+    size_t word = pos >> 6;
+    // Mask off the bits before pos in the first word
+    uint64_t diff = (data_[word] ^ other.data_[word]) & (~uint64_t(0) << (pos & 63));
+    while (diff == 0) {
+        if (++word == nwords_) return nbits_;
+        diff = data_[word] ^ other.data_[word];
+    }
+    return (word << 6) + __builtin_ctzll(diff);
+}
+
+BitSet& BitSet::operator^=(const BitSet& other) {
+    checkSize(other);
+    for (size_t i = 0; i < nwords_; i++) data_[i] ^= other.data_[i];
+    return *this;
+}
+
+BitSet& BitSet::operator&=(const BitSet& other) {
+    checkSize(other);
+    for (size_t i = 0; i < nwords_; i++) data_[i] &= other.data_[i];
+    return *this;
+}
+
+BitSet& BitSet::operator|=(const BitSet& other) {
+    checkSize(other);
+    for (size_t i = 0; i < nwords_; i++) data_[i] |= other.data_[i];
+    return *this;
+}
+
+bool BitSet::operator==(const BitSet& other) const {
+    return nbits_ == other.nbits_ && std::memcmp(data_, other.data_, nwords_ * sizeof(uint64_t)) == 0;
+}
+
+BitSet operator^(BitSet a, const BitSet& b) {
+    a ^= b;
+    return a;
+}
+
+BitSet operator&(BitSet a, const BitSet& b) {
+    a &= b;
+    return a;
+}
+
+BitSet operator|(BitSet a, const BitSet& b) {
+    a |= b;
+    return a;
+}
+
 void BitSet::check(size_t pos) const {
     if (pos >= nbits_) throw std::out_of_range("BitSet index out of range");
 }
+
+void BitSet::checkSize(const BitSet& other) const {
+    if (nbits_ != other.nbits_) throw std::invalid_argument("BitSet sizes differ");
+}
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <numeric>
+#include "components.hpp"
+#include "packed.hpp"
+
+static int findRoot(vector<int>& parent, int bit) {
+    while (parent[bit] != bit) {
+        parent[bit] = parent[parent[bit]];
+        bit = parent[bit];
+    }
+    return bit;
+}
+
+// First bomb of the count, -1 if it has none
+static int firstBit(const SolverState& state, int count) {
+    for (int slot = 0; slot < 8; slot++) {
+        if (state.countNeighborLookup[count * 8 + slot] != -1) return state.countNeighborLookup[count * 8 + slot];
+    }
+    return -1;
+}
+
+vector<Component> findComponents(const SolverState& state) {
+    const int bits = state.bombKeys.size();
+    vector<int> parent(bits);
+    iota(parent.begin(), parent.end(), 0);
+    for (size_t count = 0; count < state.targets.size(); count++) {
+        const int first = firstBit(state, count);
+        for (int slot = 0; slot < 8 && first != -1; slot++) {
+            const int bit = state.countNeighborLookup[count * 8 + slot];
+            if (bit != -1) parent[findRoot(parent, bit)] = findRoot(parent, first);
+        }
+    }
+    vector<Component> components;
+    vector<int> componentOf(bits, -1); // by root
+    for (int bit = 0; bit < bits; bit++) {
+        const int root = findRoot(parent, bit);
+        if (componentOf[root] == -1) {
+            componentOf[root] = components.size();
+            components.emplace_back();
+        }
+        components[componentOf[root]].bits.push_back(bit);
+    }
+    for (size_t count = 0; count < state.targets.size(); count++) {
+        const int first = firstBit(state, count);
+        if (first != -1) components[componentOf[findRoot(parent, first)]].counts.push_back(count);
+    }
+    return components;
+}
+
+// A count or a bomb of a component, kind is the value of a count and 10 for a bomb
+struct ShapeCell {
+    int x;
+    int y;
+    uint8_t kind;
+    int bit; // -1 for counts
+};
+
+ComponentShape canonicalShape(const Graph& graph, const SolverState& state, const Component& component) {
+    vector<ShapeCell> cells;
+    for (int count : component.counts) {
+        cells.push_back({graph.counts[count].x, graph.counts[count].y, (uint8_t)state.targets[count], -1});
+    }
+    for (int bit : component.bits) {
+        const i64 key = state.bombKeys[bit];
+        cells.push_back({(int)(key >> 32), (int)(key & 0xffffffff), 10, bit});
+    }
+    ComponentShape shape;
+    vector<ShapeCell> moved(cells.size());
+    string key;
+    // Bit 0 mirrors x, bit 1 mirrors y and bit 2 swaps them, which gives all 8 symmetries of the square
+    for (int symmetry = 0; symmetry < 8; symmetry++) {
+        int minX = INT32_MAX;
+        int minY = INT32_MAX;
+        for (size_t i = 0; i < cells.size(); i++) {
+            int x = symmetry & 1 ? -cells[i].x : cells[i].x;
+            int y = symmetry & 2 ? -cells[i].y : cells[i].y;
+            if (symmetry & 4) swap(x, y);
+            moved[i] = {x, y, cells[i].kind, cells[i].bit};
+            minX = min(minX, x);
+            minY = min(minY, y);
+        }
+        sort(moved.begin(), moved.end(), [](const ShapeCell& a, const ShapeCell& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+        // 2 bytes per coordinate, a small component is never that large
+        key.clear();
+        for (const ShapeCell& cell : moved) {
+            const int x = cell.x - minX;
+            const int y = cell.y - minY;
+            key += {(char)(x & 255), (char)(x >> 8), (char)(y & 255), (char)(y >> 8), (char)cell.kind};
+        }
+        if (symmetry == 0 || key < shape.key) {
+            shape.key = key;
+            shape.bits.clear();
+            for (const ShapeCell& cell : moved) {
+                if (cell.bit != -1) shape.bits.push_back(cell.bit);
+            }
+        }
+    }
+    shape.hash = fnv1a(FNV_OFFSET, reinterpret_cast<const uint8_t*>(shape.key.data()), shape.key.size());
+    return shape;
+}
+
+ComponentCache::ComponentCache(size_t maxBytes) : maxBytes_(maxBytes) {}
+
+size_t ComponentCache::entryBytes(const Entry& entry) {
+    // The list and map nodes around the entry take about 64 bytes
+    return sizeof(Entry) + entry.key.size() + entry.assignment.size() + 64;
+}
+
+bool ComponentCache::find(const ComponentShape& shape, vector<char>& assignment) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = index_.find(shape.hash);
+    // Another shape with the same hash is a miss too
+    if (it == index_.end() || it->second->key != shape.key) {
+        stats_.misses++;
+        return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    assignment = it->second->assignment;
+    stats_.hits++;
+    return true;
+}
+
+void ComponentCache::insert(const ComponentShape& shape, const vector<char>& assignment) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = index_.find(shape.hash);
+    if (it != index_.end()) {
+        stats_.bytes -= entryBytes(*it->second);
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+    Entry entry{shape.hash, shape.key, assignment};
+    const size_t bytes = entryBytes(entry);
+    if (bytes > maxBytes_) return;
+    entries_.push_front(move(entry));
+    index_[shape.hash] = entries_.begin();
+    stats_.bytes += bytes;
+    while (stats_.bytes > maxBytes_) {
+        stats_.bytes -= entryBytes(entries_.back());
+        index_.erase(entries_.back().hash);
+        entries_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+ComponentCacheStats ComponentCache::stats() const {
+    lock_guard<mutex> lock(mutex_);
+    ComponentCacheStats stats = stats_;
+    stats.entries = index_.size();
+    return stats;
+}
+
+// Branch and bound over the bits of one component
+// The bound of a count is how far it is off even if all its unassigned bombs go the right way
+struct ExactSearch {
+    vector<int> varCounts; // 8 slots per bit with local count indices, -1 means no more counts
+    vector<int> targets;
+    vector<int> armed;
+    vector<int> remaining;
+    vector<char> assignment;
+    vector<char> best;
+    int bound = 0; // sum of the bounds of the counts
+    int bestError = 0;
+    int nodes = 0;
+    int nodeLimit = 0;
+
+    int countBound(int count) const {
+        return max(0, armed[count] - targets[count]) + max(0, targets[count] - armed[count] - remaining[count]);
+    }
+
+    void assign(int var, int value, int change) {
+        for (int slot = 0; slot < 8; slot++) {
+            const int count = varCounts[var * 8 + slot];
+            if (count == -1) break;
+            bound -= countBound(count);
+            remaining[count] -= change;
+            armed[count] += value * change;
+            bound += countBound(count);
+        }
+    }
+
+    void search(int var) {
+        if (bound >= bestError || ++nodes > nodeLimit) return;
+        if (var == (int)assignment.size()) {
+            bestError = bound;
+            best = assignment;
+            return;
+        }
+        // Arm first if most of its counts still miss bombs
+        int need = 0;
+        for (int slot = 0; slot < 8 && varCounts[var * 8 + slot] != -1; slot++) {
+            const int count = varCounts[var * 8 + slot];
+            need += targets[count] > armed[count] ? 1 : -1;
+        }
+        const int first = need > 0 ? 1 : 0;
+        for (int value : {first, 1 - first}) {
+            assignment[var] = value;
+            assign(var, value, 1);
+            search(var + 1);
+            assign(var, value, -1);
+        }
+    }
+};
+
+// Search the assignment of the bits with the least error, starting from the current one
+// localCount maps count indices to the search and has to be -1 everywhere, it is again afterwards
+// Returns false if the search ran out of nodes, assignment is then the best one found
+static bool solveExactly(const SolverState& state, const vector<int>& bits, const vector<int>& counts, int nodeLimit,
+                         vector<int>& localCount, vector<char>& assignment) {
+    ExactSearch search;
+    search.nodeLimit = nodeLimit;
+    for (int count : counts) {
+        localCount[count] = search.targets.size();
+        search.targets.push_back(state.targets[count]);
+        search.armed.push_back(0);
+        search.remaining.push_back(0);
+        search.bestError += countError(state, count);
+    }
+    search.varCounts.assign(bits.size() * 8, -1);
+    search.best.resize(bits.size());
+    for (size_t var = 0; var < bits.size(); var++) {
+        const int bit = bits[var];
+        for (int slot = 0; slot < 8; slot++) {
+            const int count = state.bitsetImpactLookup[bit * 8 + slot];
+            if (count == -1) break;
+            search.varCounts[var * 8 + slot] = localCount[count];
+            search.remaining[localCount[count]]++;
+        }
+        search.best[var] = state.current.test(bit);
+    }
+    for (size_t local = 0; local < counts.size(); local++) {
+        localCount[counts[local]] = -1;
+        search.bound += search.countBound(local);
+    }
+    // The current assignment is the one to beat
+    search.assignment.resize(bits.size());
+    search.search(0);
+    assignment = search.best;
+    return search.nodes <= nodeLimit;
+}
+
+vector<int> solveComponents(const Graph& graph, SolverState& state, ComponentCache* cache, const ComponentOptions& options) {
+    vector<int> undecided;
+    vector<int> localCount(state.targets.size(), -1);
+    vector<char> assignment;
+    for (const Component& component : findComponents(state)) {
+        if ((int)component.bits.size() > options.maxBombs) {
+            undecided.insert(undecided.end(), component.bits.begin(), component.bits.end());
+            continue;
+        }
+        const ComponentShape shape = canonicalShape(graph, state, component);
+        bool decided = true;
+        if (cache == nullptr || !cache->find(shape, assignment)) {
+            decided = solveExactly(state, shape.bits, component.counts, options.nodeLimit, localCount, assignment);
+            if (decided && cache != nullptr) cache->insert(shape, assignment);
+        }
+        for (size_t i = 0; i < shape.bits.size(); i++) {
+            if (state.current.test(shape.bits[i]) != (bool)assignment[i]) applyFlip(state, shape.bits[i]);
+        }
+        // The search continues from the best assignment found
+        if (!decided) undecided.insert(undecided.end(), shape.bits.begin(), shape.bits.end());
+    }
+    return undecided;
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <stdexcept>
+#include "deltas.hpp"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DELTAS_X86
+#include <immintrin.h>
+#endif
+
+// The kernels compute the error of a count from its mask instead of looking it up in MASK_ERROR:
+// |target - popcount(mask)|, the popcount comes from a nibble table in a register,
+// which saves the table gathers
+
+template <typename Index>
+static void deltasScalar(const SolverState& state, const Index* impacts, int first, int count, int* deltas) {
+    for (int i = 0; i < count; i++) {
+        deltas[i] = flipScoreImpact(state, impacts, first + i);
+    }
+}
+
+#ifdef DELTAS_X86
+// Error of 4 counts with and without the flip, slots without a count have bit 0 and give 0
+template <typename Index>
+__attribute__((target("sse4.1")))
+static __m128i slotDeltasSse4(const SolverState& state, const Index* slots, const uint8_t* bits) {
+    const __m128i nibbles = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi32(15);
+    const uint32_t* masks = state.countMasks.data();
+    // No gathers before AVX2, the masks get loaded one by one
+    // Empty slots load the mask of count 0, their bit is 0 so the mask does not matter
+    auto index = [](Index slot) { return slot == noCount<Index>() ? 0 : slot; };
+    const __m128i maskState = _mm_setr_epi32(
+        masks[index(slots[0])], masks[index(slots[1])], masks[index(slots[2])], masks[index(slots[3])]);
+    int packed;
+    __builtin_memcpy(&packed, bits, 4);
+    const __m128i bit = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+    const __m128i target = _mm_srli_epi32(maskState, 8);
+    const __m128i before = _mm_and_si128(maskState, _mm_set1_epi32(255));
+    const __m128i after = _mm_xor_si128(before, bit);
+    const __m128i countBefore = _mm_add_epi32(
+        _mm_shuffle_epi8(nibbles, _mm_and_si128(before, low)),
+        _mm_shuffle_epi8(nibbles, _mm_srli_epi32(before, 4)));
+    const __m128i countAfter = _mm_add_epi32(
+        _mm_shuffle_epi8(nibbles, _mm_and_si128(after, low)),
+        _mm_shuffle_epi8(nibbles, _mm_srli_epi32(after, 4)));
+    return _mm_sub_epi32(
+        _mm_abs_epi32(_mm_sub_epi32(target, countAfter)),
+        _mm_abs_epi32(_mm_sub_epi32(target, countBefore)));
+}
+
+template <typename Index>
+__attribute__((target("sse4.1")))
+static __m128i bombDeltaSse4(const SolverState& state, const Index* impacts, int bomb) {
+    const Index* slots = impacts + bomb * 8;
+    const uint8_t* bits = state.impactBits.data() + bomb * 8;
+    return _mm_add_epi32(slotDeltasSse4(state, slots, bits), slotDeltasSse4(state, slots + 4, bits + 4));
+}
+
+template <typename Index>
+__attribute__((target("sse4.1")))
+static void deltasSse4(const SolverState& state, const Index* impacts, int first, int count, int* deltas) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const int bomb = first + i;
+        // Two rounds of horizontal adds leave the sum of each bomb in its own lane
+        const __m128i sums = _mm_hadd_epi32(
+            _mm_hadd_epi32(bombDeltaSse4(state, impacts, bomb), bombDeltaSse4(state, impacts, bomb + 1)),
+            _mm_hadd_epi32(bombDeltaSse4(state, impacts, bomb + 2), bombDeltaSse4(state, impacts, bomb + 3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(deltas + i), sums);
+    }
+    deltasScalar(state, impacts, first + i, count - i, deltas + i);
+}
+
+// The 8 slots of a bomb widened to 32 bit lanes
+__attribute__((target("avx2")))
+static __m256i loadSlots(const int* slots) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slots));
+}
+
+__attribute__((target("avx2")))
+static __m256i loadSlots(const uint16_t* slots) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(slots)));
+}
+
+// The error changes of all 8 counts of a bomb
+template <typename Index>
+__attribute__((target("avx2")))
+static __m256i bombDeltaAvx2(const SolverState& state, const Index* impacts, int bomb) {
+    const __m256i nibbles = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi32(15);
+    const __m256i slots = loadSlots(impacts + bomb * 8);
+    // Empty slots are masked out of the gather and their bit is 0
+    const __m256i empty = _mm256_cmpeq_epi32(slots, _mm256_set1_epi32((int)noCount<Index>()));
+    const __m256i used = _mm256_xor_si256(empty, _mm256_set1_epi32(-1));
+    const __m256i maskState = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), reinterpret_cast<const int*>(state.countMasks.data()), slots, used, 4);
+    const __m256i bit = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(state.impactBits.data() + bomb * 8)));
+    const __m256i target = _mm256_srli_epi32(maskState, 8);
+    const __m256i before = _mm256_and_si256(maskState, _mm256_set1_epi32(255));
+    const __m256i after = _mm256_xor_si256(before, bit);
+    const __m256i countBefore = _mm256_add_epi32(
+        _mm256_shuffle_epi8(nibbles, _mm256_and_si256(before, low)),
+        _mm256_shuffle_epi8(nibbles, _mm256_srli_epi32(before, 4)));
+    const __m256i countAfter = _mm256_add_epi32(
+        _mm256_shuffle_epi8(nibbles, _mm256_and_si256(after, low)),
+        _mm256_shuffle_epi8(nibbles, _mm256_srli_epi32(after, 4)));
+    return _mm256_sub_epi32(
+        _mm256_abs_epi32(_mm256_sub_epi32(target, countAfter)),
+        _mm256_abs_epi32(_mm256_sub_epi32(target, countBefore)));
+}
+
+template <typename Index>
+__attribute__((target("avx2")))
+static void deltasAvx2(const SolverState& state, const Index* impacts, int first, int count, int* deltas) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int bomb = first + i;
+        // Horizontal adds within the 128 bit halves, then the halves get added
+        const __m256i h01 = _mm256_hadd_epi32(bombDeltaAvx2(state, impacts, bomb), bombDeltaAvx2(state, impacts, bomb + 1));
+        const __m256i h23 = _mm256_hadd_epi32(bombDeltaAvx2(state, impacts, bomb + 2), bombDeltaAvx2(state, impacts, bomb + 3));
+        const __m256i h45 = _mm256_hadd_epi32(bombDeltaAvx2(state, impacts, bomb + 4), bombDeltaAvx2(state, impacts, bomb + 5));
+        const __m256i h67 = _mm256_hadd_epi32(bombDeltaAvx2(state, impacts, bomb + 6), bombDeltaAvx2(state, impacts, bomb + 7));
+        const __m256i h0123 = _mm256_hadd_epi32(h01, h23);
+        const __m256i h4567 = _mm256_hadd_epi32(h45, h67);
+        // Lanes are now bomb 0-3 of the low halves, bomb 4-7 of the low halves, and the same for the high halves
+        const __m256i lows = _mm256_permute2x128_si256(h0123, h4567, 0x20);
+        const __m256i highs = _mm256_permute2x128_si256(h0123, h4567, 0x31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(deltas + i), _mm256_add_epi32(lows, highs));
+    }
+    deltasScalar(state, impacts, first + i, count - i, deltas + i);
+}
+#endif
+
+bool deltaKernelSupported(DeltaKernel kernel) {
+    switch (kernel) {
+        case DeltaKernel::Auto:
+        case DeltaKernel::Scalar:
+            return true;
+#ifdef DELTAS_X86
+        case DeltaKernel::Sse4:
+            return __builtin_cpu_supports("sse4.1");
+        case DeltaKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+DeltaKernel bestDeltaKernel() {
+    // SSE4 has to load the masks one by one, which measured slower than the scalar loop,
+    // so it is only used when asked for
+    static const DeltaKernel best = deltaKernelSupported(DeltaKernel::Avx2) ? DeltaKernel::Avx2 : DeltaKernel::Scalar;
+    return best;
+}
+
+const char* deltaKernelName(DeltaKernel kernel) {
+    switch (kernel) {
+        case DeltaKernel::Auto: return "auto";
+        case DeltaKernel::Scalar: return "scalar";
+        case DeltaKernel::Sse4: return "sse4";
+        case DeltaKernel::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+template <typename Index>
+void flipDeltas(const SolverState& state, const Index* impacts, int first, int count, int* deltas, DeltaKernel kernel) {
+    if (kernel == DeltaKernel::Auto) kernel = bestDeltaKernel();
+    if (!deltaKernelSupported(kernel)) {
+        throw invalid_argument(string("Delta kernel not supported on this CPU: ") + deltaKernelName(kernel));
+    }
+    // Without counts every delta is 0, and the kernels could not load the mask of count 0
+    if (state.countMasks.empty()) kernel = DeltaKernel::Scalar;
+    switch (kernel) {
+#ifdef DELTAS_X86
+        case DeltaKernel::Sse4:
+            deltasSse4(state, impacts, first, count, deltas);
+            return;
+        case DeltaKernel::Avx2:
+            deltasAvx2(state, impacts, first, count, deltas);
+            return;
+#endif
+        default:
+            deltasScalar(state, impacts, first, count, deltas);
+    }
+}
+
+template void flipDeltas<int>(const SolverState&, const int*, int, int, int*, DeltaKernel);
+template void flipDeltas<uint16_t>(const SolverState&, const uint16_t*, int, int, int*, DeltaKernel);
+
+void flipDeltas(const SolverState& state, int first, int count, int* deltas, DeltaKernel kernel) {
+    flipDeltas(state, state.bitsetImpactLookup.data(), first, count, deltas, kernel);
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include "generator.hpp"
+
+// Salts so that the decisions of a cell are independent of each other
+static const uint64_t SALT_MINE = 1;
+static const uint64_t SALT_MASK = 2;
+static const uint64_t SALT_INFEASIBLE = 3;
+static const uint64_t SALT_WRONG_VALUE = 4;
+static const uint64_t SALT_CLUSTER = 5;
+
+// Side length of the lattice the cluster noise is interpolated from
+static const int CLUSTER_SCALE = 8;
+
+// splitmix64 of the seed, the salt and the coordinates
+static uint64_t cellHash(uint64_t seed, uint64_t salt, int x, int y) {
+    uint64_t z = seed ^ (salt * 0xd1342543de82ef95ULL) ^ ((uint64_t)(uint32_t)x << 32) ^ (uint32_t)y;
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Float in [0, 1) of the cell
+static float cellUnit(uint64_t seed, uint64_t salt, int x, int y) {
+    return (cellHash(seed, salt, x, y) >> 40) * 0x1.0p-24f;
+}
+
+// Value noise, bilinear interpolation of random values on a coarse lattice
+static float clusterNoise(uint64_t seed, int x, int y) {
+    const int lx = x / CLUSTER_SCALE;
+    const int ly = y / CLUSTER_SCALE;
+    const float fx = (float)(x % CLUSTER_SCALE) / CLUSTER_SCALE;
+    const float fy = (float)(y % CLUSTER_SCALE) / CLUSTER_SCALE;
+    const float top = cellUnit(seed, SALT_CLUSTER, lx, ly) * (1 - fx) + cellUnit(seed, SALT_CLUSTER, lx + 1, ly) * fx;
+    const float bottom = cellUnit(seed, SALT_CLUSTER, lx, ly + 1) * (1 - fx) + cellUnit(seed, SALT_CLUSTER, lx + 1, ly + 1) * fx;
+    return top * (1 - fy) + bottom * fy;
+}
+
+static bool isMine(const GeneratorOptions& options, int x, int y) {
+    float chance = options.density;
+    if (options.clustered) {
+        // The noise averages to one half, so the overall density stays about the same
+        chance = min(1.0f, options.density * 2 * clusterNoise(options.seed, x, y));
+    }
+    return cellUnit(options.seed, SALT_MINE, x, y) < chance;
+}
+
+static void fillMines(const GeneratorOptions& options, int y, vector<char>& mines) {
+    for (int x = 0; x < options.width; x++) {
+        mines[x] = y >= 0 && y < options.height && isMine(options, x, y);
+    }
+}
+
+int generateRows(const GeneratorOptions& options, const function<void(const string& row, const string& solutionRow)>& emit) {
+    int plantedError = 0;
+    // Mines of the previous, the current and the next row
+    vector<char> above(options.width), current(options.width), below(options.width);
+    fillMines(options, -1, above);
+    fillMines(options, 0, current);
+    string row(options.width, '.');
+    string solutionRow(options.width, '.');
+    for (int y = 0; y < options.height; y++) {
+        fillMines(options, y + 1, below);
+        for (int x = 0; x < options.width; x++) {
+            if (current[x]) {
+                row[x] = '.';
+                solutionRow[x] = 'X';
+                continue;
+            }
+            int count = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = x + dx;
+                if (nx < 0 || nx >= options.width) continue;
+                count += above[nx] + below[nx] + (dx != 0 ? current[nx] : 0);
+            }
+            if (count == 0 || cellUnit(options.seed, SALT_MASK, x, y) < options.mask) {
+                row[x] = '.';
+                solutionRow[x] = '.';
+                continue;
+            }
+            int value = count;
+            if (cellUnit(options.seed, SALT_INFEASIBLE, x, y) < options.infeasible) {
+                // Any other single digit which a count could have
+                value = (count + 1 + cellHash(options.seed, SALT_WRONG_VALUE, x, y) % 8) % 9;
+                plantedError += abs(value - count);
+            }
+            row[x] = '0' + value;
+            solutionRow[x] = '0' + value;
+        }
+        emit(row, solutionRow);
+        swap(above, current);
+        swap(current, below);
+    }
+    return plantedError;
+}
+
+GeneratedBoard generateBoard(const GeneratorOptions& options) {
+    GeneratedBoard generated;
+    generated.board.width = options.width;
+    generated.board.height = options.height;
+    generated.solution.width = options.width;
+    generated.solution.height = options.height;
+    generated.plantedError = generateRows(options, [&](const string& row, const string& solutionRow) {
+        generated.board.field.push_back(row);
+        generated.solution.field.push_back(solutionRow);
+    });
+    return generated;
+}
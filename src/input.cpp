@@ -0,0 +1,129 @@
+#include <fstream>
+#include <stdexcept>
+#include "input.hpp"
+#include "packed.hpp"
+#include "scan.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const string& path) : data_(nullptr), size_(0), mapped_(false) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Could not open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not stat " + path);
+    }
+    size_ = info.st_size;
+    if (size_ > 0) {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Could not map " + path);
+        }
+        // The files get read once from the start to the end
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapping);
+        mapped_ = true;
+    }
+    // The mapping stays valid after the file is closed
+    close(fd);
+#else
+    // No mmap on Windows, the file gets read at once instead
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        throw runtime_error("Could not open " + path);
+    }
+    size_ = in.tellg();
+    char* buffer = new char[size_];
+    in.seekg(0);
+    in.read(buffer, size_);
+    data_ = buffer;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (data_ == nullptr) return;
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#else
+    delete[] data_;
+#endif
+}
+
+const char* MappedFile::data() const {
+    return data_;
+}
+
+size_t MappedFile::size() const {
+    return size_;
+}
+
+MappedBoard::MappedBoard(const string& path) : file_(path) {
+    if (file_.size() > 0) {
+        board_ = readInputBoard(file_.data(), file_.size());
+    }
+}
+
+const InputBoard& MappedBoard::board() const {
+    return board_;
+}
+
+const MappedFile& MappedBoard::file() const {
+    return file_;
+}
+
+// The scan checks every character too, so a malformed board fails here instead of in the solver
+InputBoard readInputBoard(const char* data, size_t size) {
+    InputBoard board;
+    if (isPacked(data, size)) {
+        board.plane = unpackPlane(data, size);
+        board.packed = true;
+        board.width = board.plane.width;
+        board.height = board.plane.height;
+    } else {
+        board.view = scanBoard(data, size).view;
+        board.width = board.view.width;
+        board.height = board.view.height;
+    }
+    return board;
+}
+
+Graph graphOf(const InputBoard& board, pmr::memory_resource* memory) {
+    return board.packed ? fromPlane(board.plane, memory) : fromBoard(board.view, memory);
+}
+
+CellPlane planeOf(const InputBoard& board) {
+    return board.packed ? board.plane : planeOf(board.view);
+}
+
+BoardView rowsOf(const InputBoard& board, string& text) {
+    if (!board.packed) return board.view;
+    text = planeText(board.plane);
+    BoardView view;
+    view.width = board.width;
+    view.height = board.height;
+    view.rows.reserve(view.height);
+    for (int y = 0; y < view.height; y++) {
+        view.rows.push_back(text.data() + (size_t)y * (board.width + 1));
+    }
+    return view;
+}
+
+string readText(istream& in) {
+    string text;
+    char chunk[1 << 16];
+    while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0) {
+        text.append(chunk, in.gcount());
+    }
+    return text;
+}
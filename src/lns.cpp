@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cstdlib>
+#include "lns.hpp"
+
+// How often to try to find a violated count before settling for any count
+static const int PICK_ATTEMPTS = 32;
+
+int lnsPickCount(const SolverState& state, Rng& rng) {
+    const uint32_t countAmount = state.targets.size();
+    int countIndex = rng.below(countAmount);
+    for (int attempt = 0; attempt < PICK_ATTEMPTS; attempt++) {
+        if (countError(state, countIndex) != 0) {
+            break;
+        }
+        countIndex = rng.below(countAmount);
+    }
+    return countIndex;
+}
+
+// Lower bound of the error of a local count
+// Exact once all of its window neighbors are assigned
+static int countBound(const LnsWindow& window, int local, int target) {
+    int armed = window.fixedArmed[local] + window.armed[local];
+    if (armed > target) {
+        return armed - target;
+    }
+    if (armed + window.remaining[local] < target) {
+        return target - armed - window.remaining[local];
+    }
+    return 0;
+}
+
+// Depth first search over the window bombs
+// bound is the sum of the lower bounds of all local counts
+static void search(const SolverState& state, LnsWindow& window, int depth, int bound, int nodeLimit) {
+    if (bound >= window.bestError || window.nodes >= nodeLimit) {
+        return;
+    }
+    window.nodes++;
+    if (depth == (int)window.vars.size()) {
+        window.bestError = bound;
+        window.bestAssignment = window.assignment;
+        return;
+    }
+    const int row = depth * 8;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        const char value = attempt == 0 ? window.firstValue[depth] : !window.firstValue[depth];
+        int newBound = bound;
+        for (int slot = 0; slot < 8; slot++) {
+            int local = window.varCounts[row + slot];
+            if (local == -1) break;
+            int target = state.targets[window.counts[local]];
+            newBound -= countBound(window, local, target);
+            window.remaining[local]--;
+            window.armed[local] += value;
+            newBound += countBound(window, local, target);
+        }
+        window.assignment[depth] = value;
+        search(state, window, depth + 1, newBound, nodeLimit);
+        // Undo the assignment
+        for (int slot = 0; slot < 8; slot++) {
+            int local = window.varCounts[row + slot];
+            if (local == -1) break;
+            window.remaining[local]++;
+            window.armed[local] -= value;
+        }
+    }
+}
+
+LnsWindow::LnsWindow(pmr::memory_resource* memory)
+    : vars(memory),
+      varCounts(memory),
+      counts(memory),
+      countSlot(memory),
+      fixedArmed(memory),
+      armed(memory),
+      remaining(memory),
+      firstValue(memory),
+      assignment(memory),
+      bestAssignment(memory) {}
+
+void lnsReserve(LnsWindow& window, const SolverState& state, const LahcOptions& options) {
+    // A window frees at most side * side bombs, and their counts are at most one cell outside of it
+    const size_t side = max(0, options.lnsWindow);
+    const size_t bombs = side * side;
+    const size_t counts = (side + 2) * (side + 2);
+    window.countSlot.assign(state.targets.size(), -1);
+    window.vars.reserve(bombs);
+    window.varCounts.reserve(8 * bombs);
+    window.counts.reserve(counts);
+    window.fixedArmed.reserve(counts);
+    window.armed.reserve(counts);
+    window.remaining.reserve(counts);
+    window.firstValue.reserve(bombs);
+    window.assignment.reserve(bombs);
+    window.bestAssignment.reserve(bombs);
+}
+
+int lnsRepairWindow(
+    const Graph& graph,
+    const SolverState& state,
+    LnsWindow& window,
+    int countIndex,
+    const LahcOptions& options,
+    Rng& rng
+) {
+    // Reset the buffers of the previous step
+    if (window.countSlot.size() != state.targets.size()) {
+        window.countSlot.assign(state.targets.size(), -1);
+    } else {
+        for (int global : window.counts) {
+            window.countSlot[global] = -1;
+        }
+    }
+    window.vars.clear();
+    window.varCounts.clear();
+    window.counts.clear();
+    window.fixedArmed.clear();
+    window.armed.clear();
+    window.remaining.clear();
+    window.firstValue.clear();
+    window.assignment.clear();
+    window.bestAssignment.clear();
+    window.nodes = 0;
+
+    // Destroy: free every bomb inside of the window
+    const Count& center = graph.counts[countIndex];
+    const int half = options.lnsWindow / 2;
+    for (int y = center.y - half; y < center.y - half + options.lnsWindow; y++) {
+        for (int x = center.x - half; x < center.x - half + options.lnsWindow; x++) {
+            auto it = state.bombIndexMap.find(bombKey(x, y));
+            if (it != state.bombIndexMap.end()) {
+                window.vars.push_back(it->second);
+            }
+        }
+    }
+    if (window.vars.empty()) {
+        return 0;
+    }
+
+    // Collect the counts touched by the window
+    int currentError = 0;
+    for (int var : window.vars) {
+        const bool armed = state.current.test(var);
+        for (int slot = 0; slot < 8; slot++) {
+            int global = state.bitsetImpactLookup[var * 8 + slot];
+            if (global != -1 && window.countSlot[global] == -1) {
+                window.countSlot[global] = window.counts.size();
+                window.counts.push_back(global);
+                window.fixedArmed.push_back(armedCount(state, global));
+                window.armed.push_back(0);
+                window.remaining.push_back(0);
+                currentError += countError(state, global);
+            }
+            window.varCounts.push_back(global == -1 ? -1 : window.countSlot[global]);
+            if (global != -1) {
+                int local = window.countSlot[global];
+                // The window neighbors are not part of the fixed boundary
+                window.fixedArmed[local] -= armed;
+                window.remaining[local]++;
+            }
+        }
+        window.firstValue.push_back(rng.below(2));
+        window.assignment.push_back(armed);
+    }
+
+    // Repair: only assignments which are at least as good as the current one are searched for
+    int bound = 0;
+    for (size_t local = 0; local < window.counts.size(); local++) {
+        bound += countBound(window, local, state.targets[window.counts[local]]);
+    }
+    window.bestError = currentError + 1;
+    search(state, window, 0, bound, options.lnsNodeLimit);
+    if (window.bestAssignment.empty()) {
+        // Ran out of nodes, keep the window as it is
+        window.bestError = currentError;
+        for (size_t i = 0; i < window.vars.size(); i++) {
+            window.bestAssignment.push_back(state.current.test(window.vars[i]));
+        }
+    }
+    return window.bestError - currentError;
+}
+
+void lnsApplyWindow(SolverState& state, const LnsWindow& window) {
+    for (size_t i = 0; i < window.vars.size(); i++) {
+        const int var = window.vars[i];
+        if (state.current.test(var) != (bool)window.bestAssignment[i]) {
+            applyFlip(state, var);
+        }
+    }
+}
@@ -1,45 +1,552 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <random>
+#include <memory>
+#include <chrono>
 #include "representation.hpp"
 #include "optimization.hpp"
+#include "telemetry.hpp"
+#include "report.hpp"
+#include "input.hpp"
+#include "packed.hpp"
+#include "output.hpp"
+#include "arena.hpp"
+#include "tiles.hpp"
+#include "stream.hpp"
+#include "components.hpp"
+#include "results.hpp"
 
 using namespace std;
 
-int main() {
-    Board b;
-    // From stdin fill up the board
-    bool first = true;
-    while (true) {
-        string line;
-        if (!getline(cin, line)) break;
-        // Assume empty lines are not part of the board
-        if(line.empty()) continue;
-        if(first) {
-            first = false;
-            b.width = line.size();
+// How a board gets solved and written, the same for every board of a batch
+struct RunSettings {
+    LahcOptions opts;
+    int k; // iterations per bomb
+    float toMemory;
+    OutputMode output;
+    bool reportPhases;
+    ResultCache* results = nullptr; // boards which were solved before get answered from here
+    uint64_t settingsHash = 0; // mixed into the key of every board, see resultSettingsHash
+};
+
+// Counters of the caches so far, nothing for a cache which is not used
+static void printCacheStats(const RunSettings& settings, ostream& summary) {
+    if (settings.opts.componentCache != nullptr) {
+        const ComponentCacheStats stats = settings.opts.componentCache->stats();
+        summary << "Component cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                << stats.entries << " entries, " << stats.bytes / 1024 << " KB" << endl;
+    }
+    if (settings.results != nullptr) {
+        const ResultCacheStats stats = settings.results->stats();
+        summary << "Result cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                << stats.entries << " entries, " << stats.bytes / 1024 << " KB"
+                << (settings.results->readOnly() ? ", file written by another process" : "") << endl;
+    }
+}
+
+// What a result depends on besides the board, a cached result is only used with the same settings
+// Without a seed any seed is fine, so the seed only counts if one was given
+static uint64_t resultSettingsHash(const RunSettings& settings, bool seeded) {
+    const LahcOptions& opts = settings.opts;
+    const string text = to_string(settings.k) + " " + to_string(settings.toMemory) + " " + to_string((int)opts.init)
+        + " " + to_string(opts.lnsPeriod) + " " + to_string(opts.lnsWindow) + " " + to_string(opts.sweepThreads)
+        + " " + to_string(opts.componentCache != nullptr) + " " + (seeded ? to_string(opts.seed) : "any");
+    return contentHash(text.data(), text.size());
+}
+
+// Write the solution in the plane, its mines are the mines of the solution
+// inputMarks are the X marks of the input for the diff output
+static void writePlane(const CellPlane& plane, const vector<pair<int, int>>& inputMarks, OutputMode output) {
+    switch (output) {
+        case OutputMode::Grid: {
+            string grid = planeText(plane);
+            cout.write(grid.data(), grid.size());
+            break;
+        }
+        case OutputMode::Packed: {
+            binaryStream(stdout);
+            string packed = packPlane(plane, true);
+            cout.write(packed.data(), packed.size());
+            break;
+        }
+        case OutputMode::Mines:
+            writeMines(armedCells(plane), cout);
+            break;
+        case OutputMode::Rle:
+            writeRle(armedCells(plane), plane.height, cout);
+            break;
+        case OutputMode::Diff:
+            writeDiff(armedCells(plane), inputMarks, cout);
+            break;
+    }
+    cout.flush();
+}
+
+// Write the result of a board which was solved before with the same settings, false if there is none
+// data are the bytes of the board, key gets the key to store the result under on a miss
+static bool writeCached(const char* data, size_t size, const InputBoard& input, const RunSettings& settings, PhaseReport& report,
+                        const string& board, ResultKey& key) {
+    phaseStart(report, "cache");
+    key = resultKey(data, size, input.width, input.height, settings.settingsHash);
+    const CachedResult* cached = settings.results->find(key);
+    if (cached == nullptr) return false;
+    const CachedResult& result = *cached;
+    CellPlane plane = planeOf(input);
+    if (!resultFits(result, plane)) {
+        settings.results->drop(key);
+        return false;
+    }
+    phaseStart(report, "output");
+    const vector<pair<int, int>> inputMarks = settings.output == OutputMode::Diff ? armedCells(plane) : vector<pair<int, int>>();
+    // The X marks of the input are no part of the solution
+    for (uint8_t& cell : plane.cells) {
+        if (cell == CELL_MINE) cell = CELL_UNKNOWN;
+    }
+    for (const auto& [x, y] : result.mines) {
+        plane.cells[(size_t)y * plane.width + x] = CELL_MINE;
+    }
+    writePlane(plane, inputMarks, settings.output);
+    phaseEnd(report);
+    ostream& summary = settings.output == OutputMode::Packed ? cerr : cout;
+    if (settings.output != OutputMode::Packed) summary << "---" << endl;
+    if (!board.empty()) summary << "Board: " << board << endl;
+    summary << "LAHC score: " << result.score << endl;
+    summary << "Iterations: " << result.iterations << endl;
+    summary << "Seed: " << result.seed << endl;
+    summary << "Cached: solved in " << result.seconds << " s before" << endl;
+    printCacheStats(settings, summary);
+    if (settings.reportPhases) {
+        printReport(report, (long long)input.width * input.height, cerr);
+    }
+    return true;
+}
+
+// Solve the graph and write the result followed by the summary
+// inputMarks are the X marks of the input for the diff output, board names the board in the summary of a batch
+// With a result cache the result gets stored under the key
+static void solveAndWrite(Graph& g, const RunSettings& settings, const vector<pair<int, int>>& inputMarks, PhaseReport& report,
+                          const string& board, const ResultKey& key) {
+    LahcOptions opts = settings.opts;
+    // Scale iterations with number of bombs
+    scaleBudget(opts, g.bombs.size(), settings.k, settings.toMemory);
+    if (settings.reportPhases) {
+        opts.onPhase = [&](const char* phase) { phaseStart(report, phase); };
+    }
+    const auto start = chrono::steady_clock::now();
+    int iterations = lahcFill(g, opts);
+    int endScore = errorScore(g);
+    if (settings.results != nullptr) {
+        const chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+        try {
+            settings.results->insert(key, {endScore, iterations, opts.seed, seconds.count(), armedCells(g)});
+        } catch (const exception& e) {
+            // The result is still written, only the file of the cache is given up
+            cerr << e.what() << ", the result cache is kept in memory only from now on" << endl;
+            settings.results->stopWriting();
+        }
+    }
+    phaseStart(report, "output");
+    const bool packedOutput = settings.output == OutputMode::Packed;
+    ostream& summary = packedOutput ? cerr : cout;
+    switch (settings.output) {
+        case OutputMode::Grid:
+            dumpGraph(g);
+            break;
+        case OutputMode::Packed: {
+            binaryStream(stdout);
+            string packed = packPlane(planeOf(g), true);
+            cout.write(packed.data(), packed.size());
+            break;
+        }
+        case OutputMode::Mines:
+            writeMines(g, cout);
+            break;
+        case OutputMode::Rle:
+            writeRle(g, cout);
+            break;
+        case OutputMode::Diff:
+            writeDiff(g, inputMarks, cout);
+            break;
+    }
+    cout.flush();
+    phaseEnd(report);
+    if (!packedOutput) summary << "---" << endl;
+    if (!board.empty()) summary << "Board: " << board << endl;
+    summary << "LAHC score: " << endScore << endl;
+    summary << "Iterations: " << iterations << endl;
+    summary << "Seed: " << opts.seed << endl;
+    printCacheStats(settings, summary);
+    if (settings.reportPhases) {
+        printReport(report, (long long)g.width * g.height, cerr);
+    }
+}
+
+// Solve every board listed in the file, one path per line, - reads the list from stdin
+// All boards are built in one arena, which is rewound between them, so once it has grown to the largest board
+// the graph, the lookups and the search buffers take no memory from the heap
+static int solveBatch(const string& listPath, const RunSettings& settings) {
+    vector<string> paths;
+    ifstream listFile;
+    if (listPath != "-") {
+        listFile.open(listPath);
+        if (!listFile) {
+            cerr << "Could not open " << listPath << endl;
+            return 1;
+        }
+    }
+    istream& list = listPath == "-" ? cin : listFile;
+    string line;
+    while (getline(list, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) paths.push_back(line);
+    }
+    Arena arena;
+    int status = 0;
+    for (const string& path : paths) {
+        arena.reset();
+        PhaseReport report;
+        try {
+            phaseStart(report, "parse");
+            MappedBoard mapped(path);
+            ResultKey key;
+            if (settings.results != nullptr) {
+                if (writeCached(mapped.file().data(), mapped.file().size(), mapped.board(), settings, report, path, key)) continue;
+            }
+            phaseStart(report, "build");
+            Graph g = graphOf(mapped.board(), &arena);
+            vector<pair<int, int>> inputMarks;
+            if (settings.output == OutputMode::Diff) {
+                inputMarks = armedCells(g);
+            }
+            solveAndWrite(g, settings, inputMarks, report, path, key);
+        } catch (const exception& e) {
+            // A broken board does not stop the batch
+            cerr << path << ": " << e.what() << endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
+// Solve the board of the input tile by tile, without ever building the graph of the whole board
+static int solveTiled(const string& inputPath, const RunSettings& settings, TileOptions tiles, PhaseReport& report) {
+    try {
+        phaseStart(report, "parse");
+        string text;
+        string unpacked;
+        unique_ptr<MappedBoard> mapped;
+        BoardView view;
+        // The tiles get cut from the rows, so a packed board is turned into text here
+        if (inputPath.empty()) {
+            binaryStream(stdin);
+            text = readText(cin);
+            view = rowsOf(readInputBoard(text.data(), text.size()), unpacked);
         } else {
-            if (line.size() != b.width) {
-                cerr << "Inconsistent row width! Line: " << line << endl;
-                return 1;
+            mapped = make_unique<MappedBoard>(inputPath);
+            view = rowsOf(mapped->board(), unpacked);
+        }
+        phaseStart(report, "tiles");
+        tiles.iterationsPerBomb = settings.k;
+        tiles.toMemory = settings.toMemory;
+        TiledResult result = tiledFill(view, settings.opts, tiles);
+        phaseStart(report, "output");
+        const bool packedOutput = settings.output == OutputMode::Packed;
+        ostream& summary = packedOutput ? cerr : cout;
+        // The marks of the input are only needed for the diff
+        const vector<pair<int, int>> inputMarks = settings.output == OutputMode::Diff ? armedCells(planeOf(view)) : vector<pair<int, int>>();
+        writePlane(result.plane, inputMarks, settings.output);
+        phaseEnd(report);
+        if (!packedOutput) summary << "---" << endl;
+        summary << "LAHC score: " << result.score << endl;
+        summary << "Iterations: " << result.iterations << endl;
+        summary << "Tiles: " << result.tiles << ", seam repairs: " << result.repairs << endl;
+        summary << "Seed: " << settings.opts.seed << endl;
+        printCacheStats(settings, summary);
+        if (settings.reportPhases) {
+            printReport(report, (long long)view.width * view.height, cerr);
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Solve the board while it is being read, every row gets written as soon as it is final
+static int solveStreamed(const string& inputPath, const RunSettings& settings, StreamOptions stream, PhaseReport& report) {
+    if (settings.output == OutputMode::Packed) {
+        cerr << "--stream can not write packed boards, their header needs the height up front" << endl;
+        return 1;
+    }
+    try {
+        ifstream file;
+        if (!inputPath.empty()) {
+            file.open(inputPath);
+            if (!file) throw runtime_error("Could not open " + inputPath);
+        }
+        istream& in = inputPath.empty() ? cin : file;
+        stream.iterationsPerBomb = settings.k;
+        stream.toMemory = settings.toMemory;
+        phaseStart(report, "stream");
+        vector<pair<int, int>> mines;
+        vector<pair<int, int>> marks;
+        auto collect = [](const string& row, int y, vector<pair<int, int>>& cells) {
+            cells.clear();
+            for (size_t x = 0; x < row.size(); x++) {
+                if (row[x] == 'X') cells.push_back({(int)x, y});
+            }
+        };
+        StreamResult result = streamFill(in, settings.opts, stream, [&](int y, const string& row, const string& input) {
+            switch (settings.output) {
+                case OutputMode::Grid:
+                case OutputMode::Packed:
+                    cout.write(row.data(), row.size());
+                    cout.put('\n');
+                    break;
+                case OutputMode::Mines:
+                    collect(row, y, mines);
+                    writeMines(mines, cout);
+                    break;
+                case OutputMode::Rle:
+                    // A single row, so it is row 0 of its own
+                    collect(row, 0, mines);
+                    writeRle(mines, 1, cout);
+                    break;
+                case OutputMode::Diff:
+                    collect(row, y, mines);
+                    collect(input, y, marks);
+                    writeDiff(mines, marks, cout);
+                    break;
             }
+            cout.flush();
+        });
+        phaseEnd(report);
+        cout << "---" << endl;
+        cout << "LAHC score: " << result.score << endl;
+        cout << "Iterations: " << result.iterations << endl;
+        cout << "Rows: " << result.rows << ", bands: " << result.bands << endl;
+        cout << "Seed: " << settings.opts.seed << endl;
+        if (settings.reportPhases) {
+            printReport(report, (long long)result.width * result.rows, cerr);
         }
-        b.field.push_back(line);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
     }
-    b.height = b.field.size();
-    Graph g = fromBoard(b);
+    return 0;
+}
+
+int main(int argc, char** argv) {
     LahcOptions opts;
-    // Scale iterations with number of bombs
+    string warmPath;
+    string inputPath;
+    string batchPath;
+    bool tiled = false;
+    TileOptions tiles;
+    bool streamed = false;
+    StreamOptions stream;
+    int streamCarry = -1; // a quarter of the band unless given
+    unique_ptr<ComponentCache> componentCache;
+    size_t resultCacheBytes = 0;
+    string resultCachePath;
+    bool seeded = false;
+    string telemetryPath;
+    uint64_t telemetryEvery = 100000;
+    bool reportPhases = false;
+    OutputMode output = OutputMode::Grid;
+    PhaseReport report;
     // Each bomb has k iterations
     int k = 50;
     float toMemory = 0.25f;
-    opts.maxIterations = k * g.bombs.size();
-    opts.scoreMemorySize = (int)((float)g.bombs.size() * (float)k * toMemory);
-    lahcFill(g, opts);
-    int endScore = errorScore(g);
-    dumpGraph(g);
-    cout << "---" << endl;
-    cout << "LAHC score: " << endScore << endl;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--lns" && i + 1 < argc) {
+            // Every n-th iteration destroys and repairs a window of the board
+            opts.lnsPeriod = stoi(argv[++i]);
+        } else if (arg == "--init" && i + 1 < argc) {
+            string init = argv[++i];
+            if (init == "random") {
+                opts.init = InitStrategy::Random;
+            } else if (init == "input") {
+                opts.init = InitStrategy::Input;
+            } else if (init == "basic") {
+                opts.init = InitStrategy::Basic;
+            } else if (init == "greedy") {
+                opts.init = InitStrategy::Greedy;
+            } else {
+                cerr << "Unknown init strategy: " << init << endl;
+                return 1;
+            }
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            // Sweep over the color classes of the bombs with N threads instead of flipping one bomb at a time
+            opts.sweepThreads = stoi(argv[++i]);
+        } else if (arg == "--tiles" && i + 1 < argc) {
+            // Solve the board in tiles of N x N cells, see tiles.hpp
+            tiled = true;
+            tiles.size = stoi(argv[++i]);
+        } else if (arg == "--tile-overlap" && i + 1 < argc) {
+            tiles.overlap = stoi(argv[++i]);
+        } else if (arg == "--tile-threads" && i + 1 < argc) {
+            tiles.threads = stoi(argv[++i]);
+        } else if (arg == "--stream" && i + 1 < argc) {
+            // Read and solve the board in bands of N rows, see stream.hpp
+            streamed = true;
+            stream.band = stoi(argv[++i]);
+        } else if (arg == "--stream-carry" && i + 1 < argc) {
+            streamCarry = stoi(argv[++i]);
+        } else if (arg == "--component-cache" && i + 1 < argc) {
+            // Solve the small components exactly and keep up to N MB of their solutions, see components.hpp
+            componentCache = make_unique<ComponentCache>(stoull(argv[++i]) << 20);
+            opts.componentCache = componentCache.get();
+        } else if (arg == "--result-cache" && i + 1 < argc) {
+            // Answer boards which were solved before from up to N MB of results
+            resultCacheBytes = stoull(argv[++i]) << 20;
+        } else if (arg == "--result-cache-file" && i + 1 < argc) {
+            // Keep the results in the file, so they survive restarts
+            resultCachePath = argv[++i];
+        } else if (arg == "--k" && i + 1 < argc) {
+            k = stoi(argv[++i]);
+        } else if (arg == "--memory" && i + 1 < argc) {
+            // Share of the iterations the score memory remembers
+            toMemory = stof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            opts.seed = stoull(argv[++i]);
+            seeded = true;
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            // Where the snapshots go, - for stderr
+            telemetryPath = argv[++i];
+        } else if (arg == "--telemetry-every" && i + 1 < argc) {
+            telemetryEvery = stoull(argv[++i]);
+        } else if (arg == "--report") {
+            // Time and memory of every phase to stderr
+            reportPhases = true;
+        } else if (arg == "--input" && i + 1 < argc) {
+            // Read the board from a file instead of stdin, the file gets memory mapped
+            inputPath = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            // Solve many boards in one process, the file lists their paths
+            batchPath = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            string mode = argv[++i];
+            if (mode == "grid") {
+                output = OutputMode::Grid;
+            } else if (mode == "packed") {
+                // The solution as a compressed packed board, the summary goes to stderr instead
+                output = OutputMode::Packed;
+            } else if (mode == "mines") {
+                output = OutputMode::Mines;
+            } else if (mode == "rle") {
+                output = OutputMode::Rle;
+            } else if (mode == "diff") {
+                output = OutputMode::Diff;
+            } else {
+                cerr << "Unknown output: " << mode << endl;
+                return 1;
+            }
+        } else if (arg == "--warm" && i + 1 < argc) {
+            // Start from a previous result
+            warmPath = argv[++i];
+            opts.init = InitStrategy::Input;
+        } else {
+            cerr << "Unknown argument: " << arg << endl;
+            return 1;
+        }
+    }
+    if (!telemetryPath.empty()) {
+        if (!telemetryCompiled()) {
+            cerr << "Telemetry is not compiled in, rebuild with make TELEMETRY=1" << endl;
+            return 1;
+        }
+        if (!telemetryConfigure(telemetryPath, telemetryEvery)) {
+            cerr << "Could not open " << telemetryPath << endl;
+            return 1;
+        }
+    }
+    if (!batchPath.empty() && (!inputPath.empty() || !warmPath.empty())) {
+        cerr << "--batch takes the boards from its list, not from --input or --warm" << endl;
+        return 1;
+    }
+    if (tiled && (!batchPath.empty() || !warmPath.empty())) {
+        cerr << "--tiles works on a single board without --warm" << endl;
+        return 1;
+    }
+    if (streamed && (tiled || !batchPath.empty() || !warmPath.empty())) {
+        cerr << "--stream works on a single board without --tiles or --warm" << endl;
+        return 1;
+    }
+    if (!seeded) {
+        // Without a seed every run is different, the seed gets printed so it can still be reproduced
+        random_device device;
+        opts.seed = (uint64_t(device()) << 32) | device();
+    }
+    if ((resultCacheBytes > 0 || !resultCachePath.empty()) && (tiled || streamed || !warmPath.empty())) {
+        cerr << "--result-cache works on whole boards without --warm" << endl;
+        return 1;
+    }
+    RunSettings settings{opts, k, toMemory, output, reportPhases};
+    unique_ptr<ResultCache> results;
+    if (resultCacheBytes > 0 || !resultCachePath.empty()) {
+        try {
+            // A file without a size gets 64 MB
+            results = make_unique<ResultCache>(resultCacheBytes > 0 ? resultCacheBytes : size_t(64) << 20, resultCachePath);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        settings.results = results.get();
+        settings.settingsHash = resultSettingsHash(settings, seeded);
+    }
+    if (!batchPath.empty()) {
+        return solveBatch(batchPath, settings);
+    }
+    if (streamed) {
+        stream.carry = streamCarry >= 0 ? streamCarry : stream.band / 4;
+        return solveStreamed(inputPath, settings, stream, report);
+    }
+    if (tiled) {
+        return solveTiled(inputPath, settings, tiles, report);
+    }
+    Graph g;
+    vector<pair<int, int>> inputMarks; // X marks of the input for the diff output
+    // From stdin fill up the board
+    ResultKey key;
+    try {
+        if (inputPath.empty()) {
+            phaseStart(report, "parse");
+            // Binary, since the board may be packed
+            binaryStream(stdin);
+            string text = readText(cin);
+            InputBoard board = readInputBoard(text.data(), text.size());
+            if (settings.results != nullptr) {
+                if (writeCached(text.data(), text.size(), board, settings, report, "", key)) return 0;
+            }
+            phaseStart(report, "build");
+            g = graphOf(board);
+        } else {
+            phaseStart(report, "parse");
+            MappedBoard mapped(inputPath);
+            if (settings.results != nullptr) {
+                if (writeCached(mapped.file().data(), mapped.file().size(), mapped.board(), settings, report, "", key)) return 0;
+            }
+            phaseStart(report, "build");
+            g = graphOf(mapped.board());
+        }
+        if (output == OutputMode::Diff) {
+            inputMarks = armedCells(g);
+        }
+        if (!warmPath.empty()) {
+            // A previous result, as text or packed
+            MappedBoard warm(warmPath);
+            string unpacked;
+            armFromBoard(g, rowsOf(warm.board(), unpacked));
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    solveAndWrite(g, settings, inputMarks, report, "", key);
     return 0;
-}
\ No newline at end of file
+}
@@ -1,11 +1,21 @@
 #include <unordered_map>
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <queue>
+#include <tuple>
+#include <limits>
 #include "optimization.hpp"
 #include "representation.hpp"
 #include "bitset.hpp"
+#include "lns.hpp"
+#include "core.hpp"
+#include "deltas.hpp"
+#include "sweep.hpp"
+#include "components.hpp"
+#include "telemetry.hpp"
 
 // The error gets calculated as the sum of 
 // all differences between counts expected value and surrounding armed bombs
@@ -56,209 +66,433 @@ void basicFill(Graph& graph) {
     }
 }
 
-// Calculate the impact of flipping a mine of the total error score
-static int lahcFlipScoreImpact(
-    const Graph& graph,
-    const BitSet& bitset,
-    const int* countNeighborLookup,
-    const int* bitsetImpactLookup,
-    int flipIndex
-) {
-    // newError - currentError
-    int delta = 0;
-    const int rowStart = flipIndex * 8;
-    // Each bomb has at max 8 neighboring counts
-    for (int slot = 0; slot < 8; ++slot) {
-        int countIndex = bitsetImpactLookup[rowStart + slot];
-        // -1 means not connected
-        if (countIndex == -1) {
-            // No more counts affected by this bomb
-            break;
+// How many ways a count has to still get satisfied, lower is tighter
+// 0 means that all of its undecided neighbors are forced
+static int greedyTightness(int missing, int undecided) {
+    if (missing <= 0 || missing >= undecided) {
+        return 0;
+    }
+    return min(missing, undecided - missing);
+}
+
+// The counts are kept in a priority queue by (tightness, undecided neighbors)
+// Entries are not updated in place, instead a new one is pushed and the stale ones are skipped
+void greedyFill(Graph& graph) {
+    pmr::memory_resource* memory = memoryOf(graph);
+    SolverState state = buildSolverState(graph);
+    const int countAmount = graph.counts.size();
+    const int bitAmount = state.bombKeys.size();
+    BitSet solution(bitAmount, memory);
+    pmr::vector<char> decided(bitAmount, 0, memory);
+    // Bombs still needed by each count and its neighbors which are not decided yet
+    pmr::vector<int> missing(state.targets, memory);
+    pmr::vector<int> undecided(countAmount, 0, memory);
+    for (int i = 0; i < countAmount; i++) {
+        for (int j = 0; j < 8; j++) {
+            if (state.countNeighborLookup[i * 8 + j] != -1) {
+                undecided[i]++;
+            }
         }
-        // Finds neighbor
-        const Count& count = graph.counts[countIndex];
-        unsigned int armedNeighbors = 0;
-        for (int j = 0; j < 8; ++j) {
-            // Calcs its amount of armedNeighbors
-            int idx = countNeighborLookup[countIndex * 8 + j];
-            if (idx != -1 && bitset.at(idx)) {
-                armedNeighbors++;
+    }
+    using Entry = tuple<int, int, int>; // tightness, undecided, count index
+    priority_queue<Entry, pmr::vector<Entry>, greater<Entry>> queue{greater<Entry>(), pmr::vector<Entry>(memory)};
+    for (int i = 0; i < countAmount; i++) {
+        if (undecided[i] > 0) {
+            queue.emplace(greedyTightness(missing[i], undecided[i]), undecided[i], i);
+        }
+    }
+    auto decide = [&](int bit, bool armed) {
+        decided[bit] = 1;
+        solution.set(bit, armed);
+        for (int slot = 0; slot < 8; slot++) {
+            int countIndex = state.bitsetImpactLookup[bit * 8 + slot];
+            if (countIndex == -1) break;
+            undecided[countIndex]--;
+            missing[countIndex] -= armed;
+            if (undecided[countIndex] > 0) {
+                queue.emplace(greedyTightness(missing[countIndex], undecided[countIndex]), undecided[countIndex], countIndex);
             }
         }
-        // Calculates the impact
-        const int currentError = abs(int(count.count) - int(armedNeighbors));
-        if (bitset.at(flipIndex)) {
-            armedNeighbors--;
-        } else {
-            armedNeighbors++;
+    };
+    while (!queue.empty()) {
+        auto [tightness, free, countIndex] = queue.top();
+        queue.pop();
+        // Skip stale entries
+        if (free != undecided[countIndex] || tightness != greedyTightness(missing[countIndex], free)) {
+            continue;
         }
-        const int newError = abs(int(count.count) - int(armedNeighbors));
-        delta += (newError - currentError); // new - current
+        const int* neighbors = &state.countNeighborLookup[countIndex * 8];
+        if (tightness == 0) {
+            // Forced, either all of the undecided neighbors are bombs or none are
+            const bool armed = missing[countIndex] > 0;
+            for (int j = 0; j < 8; j++) {
+                if (neighbors[j] != -1 && !decided[neighbors[j]]) {
+                    decide(neighbors[j], armed);
+                }
+            }
+            continue;
+        }
+        // Arm the neighbor which helps the most counts and hurts the fewest
+        int bestBit = -1;
+        int bestGain = 0;
+        for (int j = 0; j < 8; j++) {
+            int bit = neighbors[j];
+            if (bit == -1 || decided[bit]) continue;
+            int gain = 0;
+            for (int slot = 0; slot < 8; slot++) {
+                int other = state.bitsetImpactLookup[bit * 8 + slot];
+                if (other == -1) break;
+                gain += missing[other] > 0 ? 1 : -1;
+            }
+            if (bestBit == -1 || gain > bestGain) {
+                bestBit = bit;
+                bestGain = gain;
+            }
+        }
+        decide(bestBit, true);
     }
-    return delta;
+    applySolution(graph, state, solution);
+}
+
+int lahcFlipScoreImpact(const SolverState& state, int flipIndex) {
+    return flipScoreImpact(state, state.bitsetImpactLookup.data(), flipIndex);
+}
+
+void applyFlip(SolverState& state, int flipIndex) {
+    flipBit(state, state.bitsetImpactLookup.data(), flipIndex);
+}
+
+IndexWidth indexWidthFor(const SolverState& state) {
+    // The largest value is the sentinel, so it can not be a count index
+    return state.targets.size() < numeric_limits<uint16_t>::max() ? IndexWidth::Narrow : IndexWidth::Wide;
 }
 
+// Bits per flipDeltas call in flipIndex, the deltas stay on the stack
+static const int DELTA_BATCH = 256;
 
 // Find a "random" index to flip
 // The randomness is not truly uniform
 // but weighted by the impact of flipping each bit
 // The higher positive impact, the more likely it is to be chosen
 // This is done so that LAHC can converge faster
-int flipIndex(
-    const Graph& graph,
-    BitSet& bitset,
-    const int* countNeighborLookup,
-    const int* bitsetImpactLookup
-) {
-    int bitAmount = graph.bombs.size();
-    vector<float> weights(bitAmount);
+// If candidates are given, only those bits are considered
+// weights is a buffer with room for a weight per considered bit
+template <typename Index>
+static int flipIndexWith(const SolverState& state, const Index* impacts, Rng& rng, const vector<int>* candidates, float* weights) {
+    int bitAmount = candidates != nullptr ? candidates->size() : state.bombKeys.size();
     float minWeight = 0.0f;
+    // Without candidates the deltas of all bits are computed in batches by the vector kernels
+    int deltas[DELTA_BATCH];
     for (int i = 0; i < bitAmount; i++) {
-        bitset.set(i, !bitset.at(i));
-        float diff = lahcFlipScoreImpact(graph, bitset, countNeighborLookup, bitsetImpactLookup, i);
+        if (candidates == nullptr && i % DELTA_BATCH == 0) {
+            flipDeltas(state, impacts, i, min(DELTA_BATCH, bitAmount - i), deltas);
+        }
+        // The weight is how much the error would drop
+        float diff = candidates != nullptr ? -flipScoreImpact(state, impacts, (*candidates)[i]) : -deltas[i % DELTA_BATCH];
         // Uniform_int_dist expects non-negative weights
         if (diff < 0) diff = 0;
         weights[i] = diff;
-        bitset.set(i, !bitset.at(i));
         if (weights[i] < minWeight) {
             minWeight = weights[i];
         }
     }
     // Not abandoned since this improves the convergence
-    for (auto& w : weights) {
-        w -= minWeight;
+    float totalWeight = 0.0f;
+    for (int i = 0; i < bitAmount; i++) {
+        weights[i] -= minWeight;
+        totalWeight += weights[i];
     }
-    // Fairer pseudo-random
-    static thread_local mt19937 rng{random_device{}()};
+    int chosen;
     //  If all are 0 then just return a random index
-    if (all_of(weights.begin(), weights.end(), [](float w){ return w <= 0.0f; })) {
-        uniform_int_distribution<int> uni(0, bitAmount - 1);
-        return uni(rng);
+    if (totalWeight <= 0.0f) {
+        chosen = rng.below(bitAmount);
+    } else {
+        // Choose the index based on weights which are the difference on total error
+        float target = rng.unit() * totalWeight;
+        chosen = 0;
+        while (chosen < bitAmount - 1 && target >= weights[chosen]) {
+            target -= weights[chosen];
+            chosen++;
+        }
+        // Rounding can run past the last positive weight
+        while (weights[chosen] <= 0.0f) {
+            chosen--;
+        }
     }
-    // Choose the index based on weights which are the difference on total error
-    discrete_distribution<int> dist(weights.begin(), weights.end());
-    return dist(rng);
+    return candidates != nullptr ? (*candidates)[chosen] : chosen;
+}
+
+int flipIndex(const SolverState& state, Rng& rng, const vector<int>* candidates) {
+    vector<float> weights(candidates != nullptr ? candidates->size() : state.bombKeys.size());
+    return flipIndexWith(state, state.bitsetImpactLookup.data(), rng, candidates, weights.data());
 }
 
 // Algorithm which is used at the start of LAHC to fill the graph randomly
 // The hope is that random filling will give the ability to traverse the solution space better
-static void randomFill(Graph& graph) {
+static void randomFill(Graph& graph, Rng& rng) {
     for (auto& [key, bomb] : graph.bombs) {
-        // Here rand() is good enough
-        float r  = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-        bomb.armed = (r < 0.5f);
+        bomb.armed = rng.below(2);
     }
 }
 
-// Find the solution using the LAHC algorithm
-void lahcFill(Graph& graph, const LahcOptions& options) {
-    // Allocate memory for previous scores
-    int* previousScores = new int[options.scoreMemorySize];
-    // Initial setup -> random fill
-    randomFill(graph);
-    int bombCount = graph.bombs.size();
-    // If there are no bombs do nothing
-    if(bombCount != 0) {
-        // The solution state can be represented as bitset
-        BitSet current(bombCount);
-        // Map bomb coordinates to bitset index
-        unordered_map<i64, int> bombIndexMap;
-        int cbitSetIndex = 0;
-        int currentScore = errorScore(graph);
-        int bestScore = currentScore;
-        // Fill up the lahc memory with the initial score
-        for(int i = 0; i < options.scoreMemorySize; i++) {
-            previousScores[i] = currentScore;
-        }
-        // We need to a way so that each count can quickly look up the neighboring bombs in the bitset
-        // This will require an array of ints of size 8 since 0-7 are for count 0, 8-15 for count 1 and so on
-        int countNeighborLookupSize = 8 * graph.counts.size();
-        int* countNeighborLookup = new int[countNeighborLookupSize];
-        // The same for the bitset to counts, since we want to fastly calculate the impact of flipping a bit
-        int bitsetImpactLookupSize = 8 * bombCount ;
-        // Lookup the neighboring numbers in the bitset, init with -1 to indicate no neighbor
-        int* bitsetImpactLookup = new int[bitsetImpactLookupSize];
-        // Initially the bitset has no count neighbors, -1 represents that
-        fill(bitsetImpactLookup, bitsetImpactLookup + bitsetImpactLookupSize, -1);
-        // Correctly setup the datastructures
-        for(size_t i = 0; i < graph.counts.size(); i++) {
-            const Count& count = graph.counts[i];
-            for(size_t j = 0; j < 8; j++) {
-                if(count.neighbors[j] != nullptr) {
-                    i64 key = bombKey(count.neighbors[j]->x, count.neighbors[j]->y);
-                    if(bombIndexMap.find(key) == bombIndexMap.end()) {
-                        bombIndexMap[key] = cbitSetIndex;
-                        if(count.neighbors[j]->armed) {
-                            current.set(cbitSetIndex, true);
-                        }
-                        cbitSetIndex++;
-                    }
-                    int index = bombIndexMap[key];
-                    countNeighborLookup[i * 8 + j] = index;
-                    int row = index * 8;
-                    int slot = 0;
-                    while (slot < 8 && bitsetImpactLookup[row + slot] != -1) {
-                        ++slot;
-                    }
-                    if (slot < 8) {
-                        bitsetImpactLookup[row + slot] = static_cast<int>(i); // this bomb affects count i
-                    }
-                } else {
-                    // No neighbor
-                    countNeighborLookup[i * 8 + j] = -1;
+SolverState::SolverState(pmr::memory_resource* memory)
+    : current(0, memory),
+      bombIndexMap(memory),
+      bombKeys(memory),
+      countNeighborLookup(memory),
+      bitsetImpactLookup(memory),
+      impactBits(memory),
+      targets(memory),
+      countMasks(memory) {}
+
+SolverState buildSolverState(const Graph& graph) {
+    pmr::memory_resource* memory = memoryOf(graph);
+    SolverState state(memory);
+    // We need to a way so that each count can quickly look up the neighboring bombs in the bitset
+    // This will require an array of ints of size 8 since 0-7 are for count 0, 8-15 for count 1 and so on
+    state.countNeighborLookup.assign(8 * graph.counts.size(), -1);
+    state.targets.resize(graph.counts.size());
+    state.countMasks.resize(graph.counts.size());
+    // Only the bombs which touch a count can change the score, so only they get a bitset index
+    for(size_t i = 0; i < graph.counts.size(); i++) {
+        const Count& count = graph.counts[i];
+        state.targets[i] = count.count;
+        state.countMasks[i] = count.count << 8;
+        for(size_t j = 0; j < 8; j++) {
+            if(count.neighbors[j] != nullptr) {
+                i64 key = bombKey(count.neighbors[j]->x, count.neighbors[j]->y);
+                auto [it, inserted] = state.bombIndexMap.try_emplace(key, (int)state.bombKeys.size());
+                if(inserted) {
+                    state.bombKeys.push_back(key);
                 }
+                state.countNeighborLookup[i * 8 + j] = it->second;
+            }
+        }
+    }
+    int bombCount = state.bombKeys.size();
+    state.current = BitSet(bombCount, memory);
+    // The same for the bitset to counts, since we want to fastly calculate the impact of flipping a bit
+    // Initially the bitset has no count neighbors, -1 represents that
+    state.bitsetImpactLookup.assign(8 * bombCount, -1);
+    state.impactBits.assign(8 * bombCount, 0);
+    // Correctly setup the datastructures
+    for(size_t i = 0; i < graph.counts.size(); i++) {
+        const Count& count = graph.counts[i];
+        for(size_t j = 0; j < 8; j++) {
+            if(count.neighbors[j] == nullptr) {
+                continue;
+            }
+            int index = state.countNeighborLookup[i * 8 + j];
+            if(count.neighbors[j]->armed) {
+                state.current.set(index, true);
+                state.countMasks[i] |= 1 << j;
             }
+            int row = index * 8;
+            int slot = 0;
+            while (slot < 8 && state.bitsetImpactLookup[row + slot] != -1) {
+                ++slot;
+            }
+            if (slot < 8) {
+                state.bitsetImpactLookup[row + slot] = static_cast<int>(i); // this bomb affects count i
+                state.impactBits[row + slot] = 1 << j;
+            }
+        }
+        state.score += countError(state, i);
+    }
+    return state;
+}
+
+void applySolution(Graph& graph, const SolverState& state, const BitSet& solution) {
+    for(size_t index = 0; index < state.bombKeys.size(); index++) {
+        auto it = graph.bombs.find(state.bombKeys[index]);
+        if(it != graph.bombs.end()) {
+            it->second.armed = solution.at(index);
         }
-        // Now starts the fun part
-        // We already init the "best, i"
-        // now we init k, current
-        int k = 0;
-        BitSet best = current;
-        for(int iteration = 0; iteration < options.maxIterations; iteration++) {
+    }
+}
+
+// Move the state to the given solution by flipping the bits which differ
+void restoreSolution(SolverState& state, const BitSet& solution) {
+    const size_t size = state.current.size();
+    for (size_t i = state.current.nextDifference(solution, 0); i < size; i = state.current.nextDifference(solution, i + 1)) {
+        applyFlip(state, i);
+    }
+}
+
+// Run LAHC starting from the current state
+// The flips go through the given lookup, the large neighborhood steps keep using the int one of the state
+template <typename Index>
+static int searchWith(const Graph& graph, SolverState& state, const Index* impacts, const LahcOptions& options, Rng& rng, const vector<int>* candidates) {
+    pmr::memory_resource* memory = memoryOf(graph);
+    // Allocate memory for previous scores
+    pmr::vector<int> previousScores(options.scoreMemorySize, memory);
+    // Weights of flipIndex, reused by every iteration
+    pmr::vector<float> weights(candidates != nullptr ? candidates->size() : state.bombKeys.size(), memory);
+    int currentScore = state.score;
+    int bestScore = currentScore;
+    TELEMETRY_SET(bestScore, bestScore);
+    if(options.onImprove) {
+        options.onImprove(0, bestScore);
+    }
+    // Fill up the lahc memory with the initial score
+    for(int i = 0; i < options.scoreMemorySize; i++) {
+        previousScores[i] = currentScore;
+    }
+    // Buffers of the large neighborhood steps, reused between steps
+    LnsWindow window(memory);
+    if(options.lnsPeriod > 0) {
+        lnsReserve(window, state, options);
+    }
+    // Now starts the fun part
+    // We already init the "best, i"
+    // now we init k, current
+    int k = 0;
+    BitSet best(state.current.size(), memory);
+    best = state.current;
+    int iteration = 0;
+    for(; iteration < options.maxIterations; iteration++) {
+        // If we reached perfect score, stop
+        if(bestScore == 0) {
+            break;
+        }
+        int newScore;
+        bool accepted;
+        if(options.lnsPeriod > 0 && iteration % options.lnsPeriod == options.lnsPeriod - 1) {
+            // Destroy a window around a violated count and repair it exactly
+            TELEMETRY_TIMESTAMP(selectStart);
+            int countIndex = lnsPickCount(state, rng);
+            TELEMETRY_TIMESTAMP(deltaStart);
+            newScore = currentScore + lnsRepairWindow(graph, state, window, countIndex, options, rng);
+            TELEMETRY_TIMESTAMP(deltaEnd);
+            TELEMETRY_ADD(selectNs, deltaStart - selectStart);
+            TELEMETRY_ADD(deltaNs, deltaEnd - deltaStart);
+            TELEMETRY_ADD(lnsSteps, 1);
+            accepted = newScore <= currentScore || newScore <= previousScores[k];
+            if(accepted) {
+                lnsApplyWindow(state, window);
+            }
+        } else {
             // Flip a random bit
-            int fli = flipIndex(graph, current, countNeighborLookup, bitsetImpactLookup);
+            TELEMETRY_TIMESTAMP(selectStart);
+            int fli = flipIndexWith(state, impacts, rng, candidates, weights.data());
+            TELEMETRY_TIMESTAMP(deltaStart);
             // Calculate the new score
-            int newScore = currentScore + lahcFlipScoreImpact(graph, current, countNeighborLookup, bitsetImpactLookup, fli);
-            // Update bitmap based on the flip
-            current.set(fli, !current.at(fli));
-            // cout << "Iteration " << iteration << " score: " << newScore << endl;
-            // Apply the score if it is or equal to the best score
-            // (The pseucode has < but it's not that important)
-            if(newScore <= bestScore) {
-                bestScore = newScore;
-                best = current;
-            }
+            newScore = currentScore + flipScoreImpact(state, impacts, fli);
+            TELEMETRY_TIMESTAMP(deltaEnd);
+            TELEMETRY_ADD(selectNs, deltaStart - selectStart);
+            TELEMETRY_ADD(deltaNs, deltaEnd - deltaStart);
             // Here is do prefer <= since it makes
             // an actual permutation of the solution if it is equal
             // which i theorize will help more diverse traversal
-            if(newScore <= currentScore || newScore <= previousScores[k]) {
-                // Accept new state
-                currentScore = newScore;
-            } else {
-                // Revert the flip if not accepted
-                current.set(fli, !current.at(fli));
-            }
-            // Record the score in the memory
-            previousScores[k] = newScore;
-            // If we reached perfect score, stop
-            if(bestScore == 0) {
-                break;
+            accepted = newScore <= currentScore || newScore <= previousScores[k];
+            if(accepted) {
+                // Update bitmap based on the flip
+                flipBit(state, impacts, fli);
             }
-            // Next solution in the memory
-            k = (k + 1) % options.scoreMemorySize;
         }
-        // Now we need to apply the best solution to the graph
-        // Since before we used the bitset
-        for(const auto& [key, index] : bombIndexMap) {
-            auto it = graph.bombs.find(key);
-            if(it != graph.bombs.end()) {
-                it->second.armed = best.at(index);
+        // cout << "Iteration " << iteration << " score: " << newScore << endl;
+        TELEMETRY_ADD(iterations, 1);
+        TELEMETRY_ADD(accepted, accepted);
+        TELEMETRY_ADD(rejected, !accepted);
+        TELEMETRY_ADD(neutral, accepted && newScore == currentScore);
+        if(accepted) {
+            // Accept new state
+            currentScore = newScore;
+            // Apply the score if it is or equal to the best score
+            // (The pseucode has < but it's not that important)
+            if(newScore <= bestScore) {
+                if(newScore < bestScore && options.onImprove) {
+                    options.onImprove(iteration + 1, newScore);
+                }
+                TELEMETRY_ADD(improvements, newScore < bestScore);
+                bestScore = newScore;
+                TELEMETRY_SET(bestScore, bestScore);
+                best = state.current;
             }
         }
-        // Cleanup
-        delete[] countNeighborLookup;
-        delete[] bitsetImpactLookup;
+        // Record the score in the memory
+        previousScores[k] = newScore;
+        // Next solution in the memory
+        k = (k + 1) % options.scoreMemorySize;
+        TELEMETRY_TICK();
+    }
+    TELEMETRY_SNAPSHOT("end");
+    // End up in the best solution found
+    restoreSolution(state, best);
+    return iteration;
+}
+
+int lahcSearch(const Graph& graph, SolverState& state, const LahcOptions& options, Rng& rng, const vector<int>* candidates) {
+    int bombCount = state.bombKeys.size();
+    // If there are no bombs do nothing
+    if(bombCount == 0 || (candidates != nullptr && candidates->empty())) {
+        return 0;
+    }
+    // Pick the narrowest lookup the board fits into, the copy costs one pass over the int lookup
+    // A search over a few candidates (a repair, an edit, a band) would spend more on the copy than it saves
+    const bool most = candidates == nullptr || candidates->size() * 4 >= (size_t)bombCount;
+    if(options.narrowIndices && most && indexWidthFor(state) == IndexWidth::Narrow) {
+        const pmr::vector<uint16_t> impacts = narrowImpacts<uint16_t>(state, memoryOf(graph));
+        return searchWith(graph, state, impacts.data(), options, rng, candidates);
     }
-    // Nothing else to do
-    delete[] previousScores;
-}
\ No newline at end of file
+    return searchWith(graph, state, state.bitsetImpactLookup.data(), options, rng, candidates);
+}
+
+void scaleBudget(LahcOptions& options, int bombCount, int iterationsPerBomb, float toMemory) {
+    options.maxIterations = iterationsPerBomb * bombCount;
+    // The memory needs at least one slot
+    options.scoreMemorySize = max(1, (int)((float)bombCount * (float)iterationsPerBomb * toMemory));
+}
+
+void initialFill(Graph& graph, InitStrategy init, Rng& rng) {
+    switch(init) {
+        case InitStrategy::Random:
+            randomFill(graph, rng);
+            break;
+        case InitStrategy::Input:
+            // Already armed by the caller
+            break;
+        case InitStrategy::Basic:
+            basicFill(graph);
+            break;
+        case InitStrategy::Greedy:
+            greedyFill(graph);
+            break;
+    }
+}
+
+// Find the solution using the LAHC algorithm
+int lahcFill(Graph& graph, const LahcOptions& options) {
+    Rng rng(options.seed, options.stream);
+    if(options.onPhase) options.onPhase("init");
+    initialFill(graph, options.init, rng);
+    // The solution state can be represented as bitset
+    if(options.onPhase) options.onPhase("lookups");
+    SolverState state = buildSolverState(graph);
+    // The bits of the small components are decided exactly, the search only gets the rest
+    vector<int> undecided;
+    bool componentsSolved = false;
+    if(options.componentCache != nullptr) {
+        if(options.onPhase) options.onPhase("components");
+        undecided = solveComponents(graph, state, options.componentCache);
+        // Without candidates the search can use the vector kernels, so they are only given if they leave something out
+        componentsSolved = undecided.size() < state.bombKeys.size();
+    }
+    if(options.sweepThreads > 0) {
+        // The coloring is part of the lookups, it only depends on the board
+        // The bits of the solved components are left out, so the sweeps never flip them
+        Coloring coloring = colorBits(state, componentsSolved ? &undecided : nullptr);
+        if(options.onPhase) options.onPhase("search");
+        int iterations = sweepSearch(graph, state, coloring, options, rng);
+        if(options.onPhase) options.onPhase("apply");
+        applySolution(graph, state, state.current);
+        return iterations;
+    }
+    if(options.onPhase) options.onPhase("search");
+    int iterations = lahcSearch(graph, state, options, rng, componentsSolved ? &undecided : nullptr);
+    if(options.onPhase) options.onPhase("apply");
+    // Now we need to apply the best solution to the graph
+    // Since before we used the bitset
+    applySolution(graph, state, state.current);
+    return iterations;
+}
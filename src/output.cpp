@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <charconv>
+#include "output.hpp"
+
+// The text is collected into blocks of this size before it gets written
+static const size_t WRITE_BLOCK = 1 << 20;
+
+// Appends to a buffer and writes it out in large blocks
+struct BlockWriter {
+    ostream& out;
+    string buffer;
+
+    explicit BlockWriter(ostream& out) : out(out) {
+        buffer.reserve(WRITE_BLOCK + 64);
+    }
+
+    ~BlockWriter() {
+        out.write(buffer.data(), buffer.size());
+    }
+
+    void number(long long value) {
+        char digits[24];
+        char* end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        buffer.append(digits, end);
+    }
+
+    void put(char c) {
+        buffer.push_back(c);
+    }
+
+    // Called after every line, so the buffer never grows much past a block
+    void endLine() {
+        buffer.push_back('\n');
+        if (buffer.size() >= WRITE_BLOCK) {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+};
+
+static bool rowMajor(const pair<int, int>& a, const pair<int, int>& b) {
+    return a.second != b.second ? a.second < b.second : a.first < b.first;
+}
+
+vector<pair<int, int>> armedCells(const Graph& graph) {
+    vector<pair<int, int>> cells;
+    for (const auto& [key, bomb] : graph.bombs) {
+        if (bomb.armed) cells.push_back({bomb.x, bomb.y});
+    }
+    sort(cells.begin(), cells.end(), rowMajor);
+    return cells;
+}
+
+vector<pair<int, int>> armedCells(const CellPlane& plane) {
+    vector<pair<int, int>> cells;
+    for (int y = 0; y < plane.height; y++) {
+        const uint8_t* row = plane.cells.data() + (size_t)y * plane.width;
+        for (int x = 0; x < plane.width; x++) {
+            if (row[x] == CELL_MINE) cells.push_back({x, y});
+        }
+    }
+    return cells;
+}
+
+void writeMines(const Graph& graph, ostream& out) {
+    writeMines(armedCells(graph), out);
+}
+
+void writeMines(const vector<pair<int, int>>& mines, ostream& out) {
+    BlockWriter writer(out);
+    for (const auto& [x, y] : mines) {
+        writer.number(x);
+        writer.put(' ');
+        writer.number(y);
+        writer.endLine();
+    }
+}
+
+void writeRle(const Graph& graph, ostream& out) {
+    writeRle(armedCells(graph), graph.height, out);
+}
+
+void writeRle(const vector<pair<int, int>>& mines, int height, ostream& out) {
+    BlockWriter writer(out);
+    size_t i = 0;
+    for (int y = 0; y < height; y++) {
+        int x = 0; // first cell which is not part of a written run
+        bool first = true;
+        while (i < mines.size() && mines[i].second == y) {
+            // A run of adjacent mines
+            size_t end = i + 1;
+            while (end < mines.size() && mines[end].second == y && mines[end].first == mines[end - 1].first + 1) {
+                end++;
+            }
+            if (!first) writer.put(' ');
+            first = false;
+            writer.number(mines[i].first - x);
+            writer.put(' ');
+            writer.number(end - i);
+            x = mines[end - 1].first + 1;
+            i = end;
+        }
+        writer.endLine();
+    }
+}
+
+void writeDiff(const Graph& graph, const vector<pair<int, int>>& marks, ostream& out) {
+    writeDiff(armedCells(graph), marks, out);
+}
+
+void writeDiff(const vector<pair<int, int>>& mines, const vector<pair<int, int>>& marks, ostream& out) {
+    BlockWriter writer(out);
+    auto line = [&](char sign, const pair<int, int>& cell) {
+        writer.put(sign);
+        writer.put(' ');
+        writer.number(cell.first);
+        writer.put(' ');
+        writer.number(cell.second);
+        writer.endLine();
+    };
+    // Both lists are row-major, so one merge finds the differences
+    size_t i = 0;
+    size_t j = 0;
+    while (i < mines.size() || j < marks.size()) {
+        if (j == marks.size() || (i < mines.size() && rowMajor(mines[i], marks[j]))) {
+            line('+', mines[i++]);
+        } else if (i == mines.size() || rowMajor(marks[j], mines[i])) {
+            line('-', marks[j++]);
+        } else {
+            i++;
+            j++;
+        }
+    }
+}
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "packed.hpp"
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+static const char MAGIC[4] = {'S', 'W', 'P', 'B'};
+
+// PackBits runs and literals are at most this long
+static const size_t MAX_RUN = 128;
+
+static void putUint(string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((char)(value >> (8 * i)));
+    }
+}
+
+// Overwrite bytes which were reserved with putUint
+static void setUint(string& out, size_t at, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[at + i] = (char)(value >> (8 * i));
+    }
+}
+
+static uint64_t getUint(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)(unsigned char)data[i] << (8 * i);
+    }
+    return value;
+}
+
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Control byte n < 128 is followed by n + 1 literal bytes, n > 128 repeats the next byte 257 - n times
+static void packBits(const uint8_t* row, size_t size, string& out) {
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < MAX_RUN && row[i + run] == row[i]) run++;
+        if (run >= 3) {
+            out.push_back((char)(257 - run));
+            out.push_back((char)row[i]);
+            i += run;
+            continue;
+        }
+        // Literals until the next run of three
+        const size_t start = i;
+        while (i < size && i - start < MAX_RUN) {
+            if (i + 2 < size && row[i] == row[i + 1] && row[i] == row[i + 2]) break;
+            i++;
+        }
+        out.push_back((char)(i - start - 1));
+        out.append(reinterpret_cast<const char*>(row + start), i - start);
+    }
+}
+
+// Returns false if the encoded row does not decode to exactly size bytes
+static bool unpackBits(const char* data, size_t length, uint8_t* row, size_t size) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < length) {
+        const uint8_t control = data[in++];
+        if (control < 128) {
+            const size_t count = control + 1;
+            if (in + count > length || out + count > size) return false;
+            memcpy(row + out, data + in, count);
+            in += count;
+            out += count;
+        } else if (control > 128) {
+            const size_t count = 257 - control;
+            if (in >= length || out + count > size) return false;
+            memset(row + out, (uint8_t)data[in++], count);
+            out += count;
+        }
+    }
+    return out == size;
+}
+
+bool isPacked(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+CellPlane planeOf(const ScannedBoard& board) {
+    CellPlane plane;
+    plane.cells = board.cells;
+    plane.width = board.view.width;
+    plane.height = board.view.height;
+    return plane;
+}
+
+CellPlane planeOf(const Graph& graph) {
+    CellPlane plane;
+    plane.width = graph.width;
+    plane.height = graph.height;
+    plane.cells.assign((size_t)graph.width * graph.height, CELL_UNKNOWN);
+    for (const auto& count : graph.counts) {
+        plane.cells[(size_t)count.y * graph.width + count.x] = count.count;
+    }
+    for (const auto& [key, bomb] : graph.bombs) {
+        if (bomb.armed) plane.cells[(size_t)bomb.y * graph.width + bomb.x] = CELL_MINE;
+    }
+    return plane;
+}
+
+CellPlane planeOf(const BoardView& board) {
+    CellPlane plane;
+    plane.width = board.width;
+    plane.height = board.height;
+    plane.cells.resize((size_t)board.width * board.height);
+    for (int y = 0; y < board.height; y++) {
+        const char* row = board.rows[y];
+        uint8_t* cells = plane.cells.data() + (size_t)y * board.width;
+        for (int x = 0; x < board.width; x++) {
+            const char cell = row[x];
+            cells[x] = cell >= '0' && cell <= '9' ? cell - '0' : cell == 'X' ? CELL_MINE : CELL_UNKNOWN;
+        }
+    }
+    return plane;
+}
+
+string planeText(const CellPlane& plane) {
+    static const char SYMBOLS[] = "0123456789X.";
+    const size_t stride = plane.width + 1;
+    string text(stride * plane.height, '\n');
+    for (int y = 0; y < plane.height; y++) {
+        const uint8_t* row = plane.cells.data() + (size_t)y * plane.width;
+        char* line = text.data() + y * stride;
+        for (int x = 0; x < plane.width; x++) {
+            line[x] = SYMBOLS[row[x]];
+        }
+    }
+    return text;
+}
+
+Graph fromPlane(const CellPlane& plane, pmr::memory_resource* memory) {
+    Graph graph{pmr::vector<Count>(memory), pmr::unordered_map<i64, Bomb>(memory), plane.width, plane.height};
+    const auto cellAt = [&](int x, int y) { return plane.cells[(size_t)y * plane.width + x]; };
+    for (int y = 0; y < plane.height; y++) {
+        for (int x = 0; x < plane.width; x++) {
+            const uint8_t cell = cellAt(x, y);
+            if (cell == CELL_MINE) {
+                Bomb& bomb = graph.bombs[bombKey(x, y)];
+                bomb.x = x;
+                bomb.y = y;
+                bomb.armed = true;
+            } else if (cell < CELL_MINE) {
+                Count count;
+                count.x = x;
+                count.y = y;
+                count.count = cell;
+                // The neighbors in the same order as fromBoard, the counts among them are skipped
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if (dx == 0 && dy == 0) continue;
+                        const int nx = x + dx;
+                        const int ny = y + dy;
+                        if (nx < 0 || nx >= plane.width || ny < 0 || ny >= plane.height) continue;
+                        const uint8_t neighbor = cellAt(nx, ny);
+                        if (neighbor < CELL_MINE) continue;
+                        Bomb& bomb = graph.bombs[bombKey(nx, ny)];
+                        bomb.x = nx;
+                        bomb.y = ny;
+                        bomb.armed = neighbor == CELL_MINE;
+                        int idx = (dy + 1) * 3 + (dx + 1);
+                        if (idx > 4) idx--;
+                        count.neighbors[idx] = &bomb;
+                    }
+                }
+                graph.counts.push_back(count);
+            }
+        }
+    }
+    return graph;
+}
+
+string packPlane(const CellPlane& plane, bool compress) {
+    const size_t rowBytes = (plane.width + 1) / 2;
+    string out(MAGIC, sizeof(MAGIC));
+    out.push_back((char)PACKED_VERSION);
+    out.push_back((char)(compress ? PACKED_COMPRESSED : 0));
+    putUint(out, 0, 2);
+    putUint(out, plane.width, 4);
+    putUint(out, plane.height, 4);
+    // The checksum gets filled in once all rows are packed
+    const size_t checksumAt = out.size();
+    putUint(out, 0, 8);
+    if (!compress) out.reserve(out.size() + rowBytes * plane.height);
+    uint64_t checksum = FNV_OFFSET;
+    vector<uint8_t> row(rowBytes);
+    for (int y = 0; y < plane.height; y++) {
+        const uint8_t* cells = plane.cells.data() + (size_t)y * plane.width;
+        for (size_t i = 0; i < rowBytes; i++) {
+            const uint8_t high = 2 * i + 1 < (size_t)plane.width ? cells[2 * i + 1] : 0;
+            row[i] = cells[2 * i] | (high << 4);
+        }
+        checksum = fnv1a(checksum, row.data(), rowBytes);
+        if (compress) {
+            const size_t lengthAt = out.size();
+            putUint(out, 0, 4);
+            packBits(row.data(), rowBytes, out);
+            setUint(out, lengthAt, out.size() - lengthAt - 4, 4);
+        } else {
+            out.append(reinterpret_cast<const char*>(row.data()), rowBytes);
+        }
+    }
+    setUint(out, checksumAt, checksum, 8);
+    return out;
+}
+
+CellPlane unpackPlane(const char* data, size_t size) {
+    if (!isPacked(data, size) || size < PACKED_HEADER_SIZE) {
+        throw runtime_error("Not a packed board");
+    }
+    if ((uint8_t)data[4] != PACKED_VERSION) {
+        throw runtime_error("Unsupported packed board version " + to_string((uint8_t)data[4]));
+    }
+    const bool compressed = data[5] & PACKED_COMPRESSED;
+    const uint64_t width = getUint(data + 8, 4);
+    const uint64_t height = getUint(data + 12, 4);
+    const uint64_t expected = getUint(data + 16, 8);
+    if (width > (uint64_t)INT32_MAX || height > (uint64_t)INT32_MAX) {
+        throw runtime_error("Packed board is too large");
+    }
+    // Rows without cells take no bytes, so the size check below could not bound their number
+    if (width == 0 && height > 0) {
+        throw runtime_error("Packed board has rows without cells");
+    }
+    const size_t rowBytes = (width + 1) / 2;
+    // Check the smallest size the rows can take before allocating, so a forged header can not make us allocate much
+    const uint64_t minRowBytes = compressed ? 4 + 2 * ((rowBytes + MAX_RUN - 1) / MAX_RUN) : rowBytes;
+    if (height > 0 && height > (size - PACKED_HEADER_SIZE) / minRowBytes) {
+        throw runtime_error("Packed board is truncated");
+    }
+    CellPlane plane;
+    plane.width = width;
+    plane.height = height;
+    plane.cells.resize(width * height);
+    uint64_t checksum = FNV_OFFSET;
+    vector<uint8_t> row(rowBytes);
+    size_t position = PACKED_HEADER_SIZE;
+    for (uint64_t y = 0; y < height; y++) {
+        if (compressed) {
+            if (position + 4 > size) throw runtime_error("Packed board is truncated");
+            const size_t length = getUint(data + position, 4);
+            position += 4;
+            if (length > size - position) throw runtime_error("Packed board is truncated");
+            if (!unpackBits(data + position, length, row.data(), rowBytes)) {
+                throw runtime_error("Malformed compressed row " + to_string(y + 1));
+            }
+            position += length;
+        } else {
+            if (rowBytes > size - position) throw runtime_error("Packed board is truncated");
+            memcpy(row.data(), data + position, rowBytes);
+            position += rowBytes;
+        }
+        checksum = fnv1a(checksum, row.data(), rowBytes);
+        uint8_t* cells = plane.cells.data() + y * width;
+        // Two cells per byte, then one check of the whole row, both loops get vectorized
+        for (uint64_t i = 0; i < width / 2; i++) {
+            cells[2 * i] = row[i] & 15;
+            cells[2 * i + 1] = row[i] >> 4;
+        }
+        if (width % 2 == 1) cells[width - 1] = row[width / 2] & 15;
+        bool malformed = false;
+        for (uint64_t x = 0; x < width; x++) {
+            malformed |= cells[x] > CELL_UNKNOWN;
+        }
+        if (malformed) {
+            const uint64_t x = find_if(cells, cells + width, [](uint8_t cell) { return cell > CELL_UNKNOWN; }) - cells;
+            throw runtime_error("Malformed cell at line " + to_string(y + 1) + ", column " + to_string(x + 1));
+        }
+    }
+    if (checksum != expected) {
+        throw runtime_error("Packed board checksum does not match");
+    }
+    return plane;
+}
+
+void binaryStream(FILE* file) {
+#ifdef _WIN32
+    _setmode(_fileno(file), _O_BINARY);
+#else
+    (void)file;
+#endif
+}
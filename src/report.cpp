@@ -0,0 +1,80 @@
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include "report.hpp"
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static double wallNow() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifndef _WIN32
+static double cpuNow() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static long peakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // Linux reports kilobytes
+    return usage.ru_maxrss;
+}
+#else
+// No getrusage on Windows, the memory is not reported there
+static double cpuNow() {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static long peakRssKb() {
+    return 0;
+}
+#endif
+
+void phaseStart(PhaseReport& report, const string& name) {
+    phaseEnd(report);
+    PhaseTiming phase;
+    phase.name = name;
+    report.phases.push_back(phase);
+    report.running = true;
+    report.wallStart = wallNow();
+    report.cpuStart = cpuNow();
+}
+
+void phaseEnd(PhaseReport& report) {
+    if (!report.running) return;
+    PhaseTiming& phase = report.phases.back();
+    phase.wallSeconds = wallNow() - report.wallStart;
+    phase.cpuSeconds = cpuNow() - report.cpuStart;
+    phase.peakRssKb = peakRssKb();
+    report.running = false;
+}
+
+void printReport(const PhaseReport& report, long long cells, ostream& out) {
+    double totalWall = 0;
+    double totalCpu = 0;
+    long peak = 0;
+    for (const PhaseTiming& phase : report.phases) {
+        totalWall += phase.wallSeconds;
+        totalCpu += phase.cpuSeconds;
+        peak = max(peak, phase.peakRssKb);
+    }
+    out << fixed << setprecision(3);
+    out << left << setw(10) << "phase" << right << setw(12) << "wall ms" << setw(12) << "cpu ms"
+        << setw(9) << "wall %" << setw(14) << "peak rss MB" << "\n";
+    for (const PhaseTiming& phase : report.phases) {
+        out << left << setw(10) << phase.name << right
+            << setw(12) << phase.wallSeconds * 1e3
+            << setw(12) << phase.cpuSeconds * 1e3
+            << setw(9) << setprecision(1) << (totalWall > 0 ? 100 * phase.wallSeconds / totalWall : 0.0)
+            << setw(14) << setprecision(3) << phase.peakRssKb / 1024.0 << "\n";
+    }
+    out << left << setw(10) << "total" << right << setw(12) << totalWall * 1e3 << setw(12) << totalCpu * 1e3
+        << setw(9) << "" << setw(14) << peak / 1024.0 << "\n";
+    out << "cells: " << cells << ", peak bytes per cell: "
+        << setprecision(1) << (cells > 0 ? peak * 1024.0 / cells : 0.0) << "\n";
+    out.unsetf(ios::floatfield);
+}
@@ -1,5 +1,7 @@
 #include "representation.hpp"
 #include <iostream>
+#include <stdexcept>
+#include <algorithm>
 using namespace std;
 
 // The hashmap key which represents a bomb at (x, y)
@@ -8,25 +10,40 @@ i64 bombKey(int x, int y) {
 }
 
 // Check if coordinates are in range of the board
-static bool inRange(const Board& board, int x, int y) {
+static bool inRange(const BoardView& board, int x, int y) {
     return x >= 0 && x < board.width && y >= 0 && y < board.height;
 }
 
 // Check if the item at the coordinates is a number
-static bool numberAt(const Board& board, int x, int y) {
+static bool numberAt(const BoardView& board, int x, int y) {
     if (!inRange(board, x, y)) return false;
-    char cell = board.field[y][x];
+    char cell = board.rows[y][x];
     return cell >= '0' && cell <= '9';
 }
 
+BoardView viewOf(const Board& board) {
+    BoardView view;
+    view.width = board.width;
+    view.height = board.height;
+    view.rows.reserve(board.height);
+    for (const string& row : board.field) {
+        view.rows.push_back(row.data());
+    }
+    return view;
+}
+
+Graph fromBoard(const Board& board, pmr::memory_resource* memory) {
+    return fromBoard(viewOf(board), memory);
+}
+
 // From a board definition, create a graph representation
-Graph fromBoard(const Board& board) {
-    Graph graph;
+Graph fromBoard(const BoardView& board, pmr::memory_resource* memory) {
+    Graph graph{pmr::vector<Count>(memory), pmr::unordered_map<i64, Bomb>(memory), 0, 0};
     graph.width = board.width;
     graph.height = board.height;
     // First pass: find bombs and counts
     for (int y = 0; y < board.height; y++) {
-        const string& row = board.field[y];
+        const char* row = board.rows[y];
         for (int x = 0; x < board.width; x++) {
             char cell = row[x];
             // If the cell is an X its a bomb, and put it in the bomb map
@@ -55,7 +72,7 @@ Graph fromBoard(const Board& board) {
                         Bomb& bomb = graph.bombs[key]; // inserts if missing
                         bomb.x = nx;
                         bomb.y = ny;
-                        bomb.armed = (board.field[ny][nx] == 'X');
+                        bomb.armed = (board.rows[ny][nx] == 'X');
                         int idx = (dy + 1) * 3 + (dx + 1);
                         if (idx > 4) idx--; // skip center
                         count.neighbors[idx] = &bomb;
@@ -68,28 +85,105 @@ Graph fromBoard(const Board& board) {
     return graph;
 }
 
-// Outs the graph to the stdout
-void dumpGraph(const Graph& graph) {
+pmr::memory_resource* memoryOf(const Graph& graph) {
+    return graph.bombs.get_allocator().resource();
+}
+
+Board readBoard(istream& in) {
+    Board board;
+    board.width = 0;
+    bool first = true;
+    string line;
+    while (getline(in, line)) {
+        // Everything after the separator is not part of the board
+        if (line == "---") break;
+        // Assume empty lines are not part of the board
+        if (line.empty()) continue;
+        if (first) {
+            first = false;
+            board.width = line.size();
+        } else if ((int)line.size() != board.width) {
+            throw runtime_error("Inconsistent row width! Line: " + line);
+        }
+        board.field.push_back(line);
+    }
+    board.height = board.field.size();
+    return board;
+}
+
+void armFromBoard(Graph& graph, const Board& marks) {
+    armFromBoard(graph, viewOf(marks));
+}
+
+void armFromBoard(Graph& graph, const BoardView& marks) {
+    if (marks.width != graph.width || marks.height != graph.height) {
+        throw invalid_argument("Board sizes do not match");
+    }
+    for (auto& [key, bomb] : graph.bombs) {
+        bomb.armed = marks.rows[bomb.y][bomb.x] == 'X';
+    }
+}
+
+// Boards whose text is larger than this get streamed in bands
+static const size_t RENDER_BUFFER_LIMIT = 64 << 20;
+
+string renderGraph(const Graph& graph) {
+    const size_t stride = graph.width + 1;
+    string buffer(stride * graph.height, '.');
     for (int y = 0; y < graph.height; y++) {
-        for (int x = 0; x < graph.width; x++) {
-            i64 key = bombKey(x, y);
-            auto it = graph.bombs.find(key);
-            if (it != graph.bombs.end()) {
-                cout << (it->second.armed ? 'X' : '.');
-                continue;
-            }
-            bool printed = false;
-            for (const auto& count : graph.counts) {
-                if (count.x == x && count.y == y) {
-                    cout << count.count;
-                    printed = true;
-                    break;
-                }
+        buffer[y * stride + graph.width] = '\n';
+    }
+    for (const auto& count : graph.counts) {
+        buffer[count.y * stride + count.x] = '0' + count.count;
+    }
+    for (const auto& [key, bomb] : graph.bombs) {
+        buffer[bomb.y * stride + bomb.x] = bomb.armed ? 'X' : '.';
+    }
+    return buffer;
+}
+
+void streamGraph(const Graph& graph, ostream& out, int bandRows) {
+    // Bucket the counts and the bombs by row, so a band only visits its own cells
+    vector<int> countStart(graph.height + 1, 0);
+    for (const auto& count : graph.counts) countStart[count.y + 1]++;
+    for (int y = 0; y < graph.height; y++) countStart[y + 1] += countStart[y];
+    vector<const Count*> countsByRow(graph.counts.size());
+    vector<int> fill(countStart.begin(), countStart.end() - 1);
+    for (const auto& count : graph.counts) countsByRow[fill[count.y]++] = &count;
+
+    vector<int> bombStart(graph.height + 1, 0);
+    for (const auto& [key, bomb] : graph.bombs) bombStart[bomb.y + 1]++;
+    for (int y = 0; y < graph.height; y++) bombStart[y + 1] += bombStart[y];
+    vector<const Bomb*> bombsByRow(graph.bombs.size());
+    fill.assign(bombStart.begin(), bombStart.end() - 1);
+    for (const auto& [key, bomb] : graph.bombs) bombsByRow[fill[bomb.y]++] = &bomb;
+
+    const size_t stride = graph.width + 1;
+    string band;
+    for (int first = 0; first < graph.height; first += bandRows) {
+        const int last = min(graph.height, first + bandRows);
+        band.assign(stride * (last - first), '.');
+        for (int y = first; y < last; y++) {
+            char* row = &band[(y - first) * stride];
+            row[graph.width] = '\n';
+            for (int i = countStart[y]; i < countStart[y + 1]; i++) {
+                row[countsByRow[i]->x] = '0' + countsByRow[i]->count;
             }
-            if (!printed) {
-                cout << '.';
+            for (int i = bombStart[y]; i < bombStart[y + 1]; i++) {
+                row[bombsByRow[i]->x] = bombsByRow[i]->armed ? 'X' : '.';
             }
         }
-        cout << '\n';
+        out.write(band.data(), band.size());
+    }
+}
+
+// Outs the graph to the stdout
+void dumpGraph(const Graph& graph) {
+    const size_t size = (size_t)(graph.width + 1) * graph.height;
+    if (size <= RENDER_BUFFER_LIMIT) {
+        string buffer = renderGraph(graph);
+        cout.write(buffer.data(), buffer.size());
+    } else {
+        streamGraph(graph, cout, max<size_t>(1, RENDER_BUFFER_LIMIT / (graph.width + 1)));
     }
 }
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <stdexcept>
+#include "resolve.hpp"
+
+// How many iterations each bomb around the edits gets before the whole board is searched
+static const int LOCAL_ITERATIONS_PER_BIT = 50;
+
+static bool isNumber(char cell) {
+    return cell >= '0' && cell <= '9';
+}
+
+static bool inRange(const Board& board, int x, int y) {
+    return x >= 0 && x < board.width && y >= 0 && y < board.height;
+}
+
+// Give the bomb a bitset index, freed indices get reused first
+static int acquireBit(Session& session, i64 key, bool armed) {
+    SolverState& state = session.state;
+    int index;
+    if (!session.freeBits.empty()) {
+        index = session.freeBits.back();
+        session.freeBits.pop_back();
+        state.bombKeys[index] = key;
+    } else {
+        index = state.bombKeys.size();
+        state.bombKeys.push_back(key);
+        state.bitsetImpactLookup.resize(state.bitsetImpactLookup.size() + 8, -1);
+        state.impactBits.resize(state.impactBits.size() + 8, 0);
+        // Grow the bitset by doubling, so that adding bombs stays amortized constant
+        if ((size_t)index >= state.current.size()) {
+            BitSet grown(max<size_t>(64, state.current.size() * 2));
+            for (size_t i = 0; i < state.current.size(); i++) {
+                grown.set(i, state.current.test(i));
+            }
+            state.current = move(grown);
+        }
+    }
+    state.bombIndexMap[key] = index;
+    // Nothing is attached to the bit yet, so the score does not change
+    state.current.set(index, armed);
+    return index;
+}
+
+// Remove the count from the lookups of its bombs
+// The bombs are remembered in touched, since they might not be used anymore
+static void detachCount(Session& session, int countIndex, vector<int>& touched) {
+    SolverState& state = session.state;
+    state.score -= countError(state, countIndex);
+    for (int j = 0; j < 8; j++) {
+        int index = state.countNeighborLookup[countIndex * 8 + j];
+        if (index == -1) continue;
+        // Remove the count from the row and keep the row packed
+        int* row = &state.bitsetImpactLookup[index * 8];
+        uint8_t* bits = &state.impactBits[index * 8];
+        int slot = 0;
+        while (row[slot] != countIndex) slot++;
+        for (; slot < 7; slot++) {
+            row[slot] = row[slot + 1];
+            bits[slot] = bits[slot + 1];
+        }
+        row[7] = -1;
+        bits[7] = 0;
+        touched.push_back(index);
+        state.countNeighborLookup[countIndex * 8 + j] = -1;
+        session.graph.counts[countIndex].neighbors[j] = nullptr;
+    }
+    state.countMasks[countIndex] = state.targets[countIndex] << 8;
+}
+
+// Link the count to the bombs around it, same as fromBoard does
+static void attachCount(Session& session, int countIndex) {
+    SolverState& state = session.state;
+    const Board& board = session.board;
+    Count& count = session.graph.counts[countIndex];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx == 0 && dy == 0) continue;
+            int nx = count.x + dx;
+            int ny = count.y + dy;
+            if (!inRange(board, nx, ny)) continue;
+            char cell = board.field[ny][nx];
+            if (isNumber(cell)) continue;
+            i64 key = bombKey(nx, ny);
+            auto [bombIt, inserted] = session.graph.bombs.try_emplace(key);
+            Bomb& bomb = bombIt->second;
+            if (inserted) {
+                bomb.x = nx;
+                bomb.y = ny;
+                bomb.armed = (cell == 'X');
+            }
+            auto bitIt = state.bombIndexMap.find(key);
+            int index = bitIt != state.bombIndexMap.end() ? bitIt->second : acquireBit(session, key, bomb.armed);
+            int idx = (dy + 1) * 3 + (dx + 1);
+            if (idx > 4) idx--; // skip center
+            state.countNeighborLookup[countIndex * 8 + idx] = index;
+            int* row = &state.bitsetImpactLookup[index * 8];
+            int slot = 0;
+            while (slot < 8 && row[slot] != -1) slot++;
+            if (slot < 8) {
+                row[slot] = countIndex;
+                state.impactBits[index * 8 + slot] = 1 << idx;
+            }
+            if (state.current.test(index)) {
+                state.countMasks[countIndex] |= 1 << idx;
+            }
+            count.neighbors[idx] = &bomb;
+            session.dirty.push_back(index);
+        }
+    }
+    state.score += countError(state, countIndex);
+}
+
+// Remove a detached count, the last count takes its index
+static void removeCount(Session& session, int countIndex) {
+    SolverState& state = session.state;
+    Graph& graph = session.graph;
+    const int last = graph.counts.size() - 1;
+    session.countIndexMap.erase(bombKey(graph.counts[countIndex].x, graph.counts[countIndex].y));
+    if (countIndex != last) {
+        graph.counts[countIndex] = graph.counts[last];
+        state.targets[countIndex] = state.targets[last];
+        state.countMasks[countIndex] = state.countMasks[last];
+        for (int j = 0; j < 8; j++) {
+            int index = state.countNeighborLookup[last * 8 + j];
+            state.countNeighborLookup[countIndex * 8 + j] = index;
+            if (index == -1) continue;
+            int* row = &state.bitsetImpactLookup[index * 8];
+            for (int slot = 0; slot < 8; slot++) {
+                if (row[slot] == last) row[slot] = countIndex;
+            }
+        }
+        session.countIndexMap[bombKey(graph.counts[countIndex].x, graph.counts[countIndex].y)] = countIndex;
+    }
+    graph.counts.pop_back();
+    state.targets.pop_back();
+    state.countMasks.pop_back();
+    state.countNeighborLookup.resize(state.countNeighborLookup.size() - 8);
+}
+
+static void addCount(Session& session, int x, int y, unsigned int value) {
+    SolverState& state = session.state;
+    Count count;
+    count.x = x;
+    count.y = y;
+    count.count = value;
+    session.countIndexMap[bombKey(x, y)] = session.graph.counts.size();
+    session.graph.counts.push_back(count);
+    state.targets.push_back(value);
+    state.countMasks.push_back(value << 8);
+    state.countNeighborLookup.resize(state.countNeighborLookup.size() + 8, -1);
+}
+
+// Free the bits which are not connected to any count anymore
+static void releaseUnused(Session& session, const vector<int>& touched) {
+    SolverState& state = session.state;
+    for (int index : touched) {
+        i64 key = state.bombKeys[index];
+        // Already released or still in use
+        if (key == -1 || state.bitsetImpactLookup[index * 8] != -1) continue;
+        int x = key >> 32;
+        int y = key & 0xffffffff;
+        auto bombIt = session.graph.bombs.find(key);
+        if (bombIt != session.graph.bombs.end()) {
+            if (session.board.field[y][x] == 'X') {
+                // Marked bombs stay in the graph even without counts
+                bombIt->second.armed = state.current.at(index);
+            } else {
+                session.graph.bombs.erase(bombIt);
+            }
+        }
+        state.current.set(index, false);
+        state.bombIndexMap.erase(key);
+        state.bombKeys[index] = -1;
+        session.freeBits.push_back(index);
+    }
+}
+
+Session startSession(const Board& board, const LahcOptions& options) {
+    Session session;
+    session.board = board;
+    session.rng = Rng(options.seed, options.stream);
+    session.graph = fromBoard(session.board);
+    lahcFill(session.graph, options);
+    session.state = buildSolverState(session.graph);
+    for (size_t i = 0; i < session.graph.counts.size(); i++) {
+        const Count& count = session.graph.counts[i];
+        session.countIndexMap[bombKey(count.x, count.y)] = i;
+    }
+    return session;
+}
+
+void applyEdit(Session& session, const CellEdit& edit) {
+    Board& board = session.board;
+    if (!inRange(board, edit.x, edit.y)) {
+        throw out_of_range("Edit outside of the board");
+    }
+    const char old = board.field[edit.y][edit.x];
+    char now = '.';
+    switch (edit.kind) {
+        case EditKind::SetCount:
+            if (edit.count > 9) {
+                throw invalid_argument("Count has to be a single digit");
+            }
+            now = '0' + edit.count;
+            break;
+        case EditKind::Clear:
+            now = '.';
+            break;
+        case EditKind::ToggleMine:
+            now = old == 'X' ? '.' : 'X';
+            break;
+    }
+    if (old == now) return;
+
+    // Only the counts around the cell can see the change
+    // They get detached, the cell changes and then they get attached again
+    vector<int> touched;
+    for (int y = edit.y - 1; y <= edit.y + 1; y++) {
+        for (int x = edit.x - 1; x <= edit.x + 1; x++) {
+            if (inRange(board, x, y) && isNumber(board.field[y][x])) {
+                detachCount(session, session.countIndexMap.at(bombKey(x, y)), touched);
+            }
+        }
+    }
+    board.field[edit.y][edit.x] = now;
+    const i64 key = bombKey(edit.x, edit.y);
+    auto bitIt = session.state.bombIndexMap.find(key);
+    if (isNumber(old) && !isNumber(now)) {
+        removeCount(session, session.countIndexMap.at(key));
+    } else if (!isNumber(old) && isNumber(now)) {
+        addCount(session, edit.x, edit.y, now - '0');
+        // The cell is not a bomb anymore
+        if (bitIt != session.state.bombIndexMap.end()) {
+            touched.push_back(bitIt->second);
+        }
+    } else if (isNumber(now)) {
+        int countIndex = session.countIndexMap.at(key);
+        session.state.targets[countIndex] = now - '0';
+        // The count is detached at this point, so its mask is empty
+        session.state.countMasks[countIndex] = (now - '0') << 8;
+        session.graph.counts[countIndex].count = now - '0';
+    }
+    if (!isNumber(now)) {
+        // A mine mark arms the bomb, since nothing is attached the score stays the same
+        if (bitIt != session.state.bombIndexMap.end()) {
+            session.state.current.set(bitIt->second, now == 'X');
+        }
+        if (now == 'X') {
+            Bomb& bomb = session.graph.bombs[key];
+            bomb.x = edit.x;
+            bomb.y = edit.y;
+            bomb.armed = true;
+        }
+    }
+    for (int y = edit.y - 1; y <= edit.y + 1; y++) {
+        for (int x = edit.x - 1; x <= edit.x + 1; x++) {
+            if (inRange(board, x, y) && isNumber(board.field[y][x])) {
+                attachCount(session, session.countIndexMap.at(bombKey(x, y)));
+            }
+        }
+    }
+    releaseUnused(session, touched);
+    // The graph only keeps bombs which are marked or next to a count
+    if (isNumber(now) || (now != 'X' && session.state.bombIndexMap.find(key) == session.state.bombIndexMap.end())) {
+        session.graph.bombs.erase(key);
+    }
+}
+
+int resolve(Session& session, const LahcOptions& options) {
+    SolverState& state = session.state;
+    vector<int>& dirty = session.dirty;
+    sort(dirty.begin(), dirty.end());
+    dirty.erase(unique(dirty.begin(), dirty.end()), dirty.end());
+    dirty.erase(remove_if(dirty.begin(), dirty.end(), [&](int index) {
+        return state.bombKeys[index] == -1;
+    }), dirty.end());
+    if (!dirty.empty()) {
+        // First only the neighborhood of the edits
+        LahcOptions local = options;
+        local.maxIterations = LOCAL_ITERATIONS_PER_BIT * dirty.size();
+        local.scoreMemorySize = max(1, local.maxIterations / 4);
+        local.lnsPeriod = 0;
+        lahcSearch(session.graph, state, local, session.rng, &dirty);
+        dirty.clear();
+    }
+    // Then the whole board if the local search was not enough
+    if (state.score > 0) {
+        lahcSearch(session.graph, state, options, session.rng);
+    }
+    applySolution(session.graph, state, state.current);
+    return state.score;
+}
@@ -0,0 +1,291 @@
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "results.hpp"
+#include "input.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+static const uint64_t PRIME1 = 0x9e3779b185ebca87ULL;
+static const uint64_t PRIME2 = 0xc2b2ae3d27d4eb4fULL;
+static const uint64_t PRIME3 = 0x165667b19e3779f9ULL;
+
+static uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t word(const char* data) {
+    uint64_t value;
+    memcpy(&value, data, 8);
+    return value;
+}
+
+static uint64_t mixLane(uint64_t lane, uint64_t input) {
+    return rotl(lane + input * PRIME2, 31) * PRIME1;
+}
+
+uint64_t contentHash(const char* data, size_t size, uint64_t seed) {
+    // The lanes do not depend on each other, so their multiplications overlap
+    uint64_t lanes[4] = {seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            lanes[lane] = mixLane(lanes[lane], word(data + i + 8 * lane));
+        }
+    }
+    uint64_t hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18) + size;
+    for (; i + 8 <= size; i += 8) {
+        hash = rotl(hash ^ mixLane(0, word(data + i)), 27) * PRIME1 + PRIME3;
+    }
+    for (; i < size; i++) {
+        hash = rotl(hash ^ (uint8_t)data[i] * PRIME3, 11) * PRIME1;
+    }
+    // Every input bit has to reach every output bit
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+ResultKey resultKey(const char* data, size_t size, int width, int height, uint64_t settings) {
+    return {contentHash(data, size, settings), size, width, height};
+}
+
+bool resultFits(const CachedResult& result, const CellPlane& board) {
+    for (const auto& [x, y] : result.mines) {
+        if (x < 0 || x >= board.width || y < 0 || y >= board.height) return false;
+        if (board.cells[(size_t)y * board.width + x] <= 9) return false;
+    }
+    return true;
+}
+
+static const char MAGIC[4] = {'S', 'W', 'R', 'C'};
+static const uint32_t VERSION = 2;
+static const size_t FILE_HEADER = 8;
+// hash, size, width, height, score, iterations, seed, seconds and mine count
+static const size_t RECORD_HEADER = 8 + 8 + 4 + 4 + 4 + 8 + 8 + 8 + 8;
+
+template <typename T>
+static void put(string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T get(const char*& in) {
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+ResultCache::ResultCache(size_t maxBytes, const string& path) : maxBytes_(maxBytes), path_(path) {
+    if (path_.empty()) return;
+    try {
+        load();
+    } catch (...) {
+        // No destructor runs for a constructor which throws
+        stopWriting();
+        throw;
+    }
+}
+
+ResultCache::~ResultCache() {
+    stopWriting();
+}
+
+size_t ResultCache::entryBytes(const Entry& entry) {
+    // The list and map nodes around the entry take about 64 bytes
+    return sizeof(Entry) + entry.result.mines.size() * sizeof(pair<int, int>) + 64;
+}
+
+string ResultCache::record(const Entry& entry) {
+    const CachedResult& result = entry.result;
+    string out;
+    out.reserve(RECORD_HEADER + result.mines.size() * 8);
+    put(out, entry.key.hash);
+    put(out, entry.key.size);
+    put(out, (uint32_t)entry.key.width);
+    put(out, (uint32_t)entry.key.height);
+    put(out, (int32_t)result.score);
+    put(out, (int64_t)result.iterations);
+    put(out, result.seed);
+    put(out, result.seconds);
+    put(out, (uint64_t)result.mines.size());
+    for (const auto& [x, y] : result.mines) {
+        put(out, (uint32_t)x);
+        put(out, (uint32_t)y);
+    }
+    return out;
+}
+
+void ResultCache::evict(list<Entry>::iterator it) {
+    stats_.bytes -= entryBytes(*it);
+    liveBytes_ -= RECORD_HEADER + it->result.mines.size() * 8;
+    index_.erase(it->key.hash);
+    entries_.erase(it);
+}
+
+void ResultCache::store(Entry entry) {
+    auto it = index_.find(entry.key.hash);
+    if (it != index_.end()) evict(it->second);
+    const size_t bytes = entryBytes(entry);
+    if (bytes > maxBytes_) return;
+    liveBytes_ += RECORD_HEADER + entry.result.mines.size() * 8;
+    entries_.push_front(move(entry));
+    index_[entries_.front().key.hash] = entries_.begin();
+    stats_.bytes += bytes;
+    while (stats_.bytes > maxBytes_) {
+        evict(prev(entries_.end()));
+        stats_.evictions++;
+    }
+}
+
+const CachedResult* ResultCache::find(const ResultKey& key) {
+    auto it = index_.find(key.hash);
+    if (it == index_.end() || it->second->key.size != key.size || it->second->key.width != key.width
+        || it->second->key.height != key.height) {
+        stats_.misses++;
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    stats_.hits++;
+    return &it->second->result;
+}
+
+void ResultCache::drop(const ResultKey& key) {
+    auto it = index_.find(key.hash);
+    if (it == index_.end()) return;
+    evict(it->second);
+    stats_.hits--;
+    stats_.misses++;
+}
+
+void ResultCache::insert(const ResultKey& key, const CachedResult& result) {
+    Entry entry{key, result};
+    bool appended = true;
+    if (log_.is_open()) {
+        const string out = record(entry);
+        log_.write(out.data(), out.size());
+        log_.flush();
+        // E.g. a full disk, the record may be torn now, which the next load skips
+        appended = (bool)log_;
+        logBytes_ += out.size();
+    }
+    store(move(entry));
+    if (!appended) throw runtime_error("Could not append to " + path_);
+    // The evicted and replaced results stay in the file until it gets too large
+    if (log_.is_open() && logBytes_ > 2 * (FILE_HEADER + liveBytes_)) compact();
+}
+
+void ResultCache::stopWriting() {
+    log_.close();
+#ifndef _WIN32
+    // Closing releases the lock, so another process can take over the writing
+    if (lockFd_ != -1) close(lockFd_);
+#endif
+    lockFd_ = -1;
+}
+
+bool ResultCache::readOnly() const {
+    return readOnly_;
+}
+
+ResultCacheStats ResultCache::stats() const {
+    ResultCacheStats stats = stats_;
+    stats.entries = index_.size();
+    return stats;
+}
+
+void ResultCache::load() {
+#ifndef _WIN32
+    // The lock is on a file of its own, since the cache file gets replaced when it is compacted
+    lockFd_ = open((path_ + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockFd_ == -1) throw runtime_error("Could not open " + path_ + ".lock");
+    if (flock(lockFd_, LOCK_EX | LOCK_NB) != 0) {
+        close(lockFd_);
+        lockFd_ = -1;
+        readOnly_ = true;
+    }
+#endif
+    bool replayed = false;
+    bool torn = false;
+    if (ifstream(path_).good()) {
+        MappedFile file(path_);
+        const char* in = file.data();
+        const char* end = in + file.size();
+        // An empty file is a new cache
+        if (file.size() > 0) {
+            if (file.size() < FILE_HEADER || memcmp(in, MAGIC, 4) != 0) {
+                throw runtime_error(path_ + " is no result cache");
+            }
+            in += 4;
+            if (get<uint32_t>(in) != VERSION) {
+                throw runtime_error(path_ + " is a result cache of another version");
+            }
+            // Replay in the order the results were written, a record cut off by a crash (or still being written
+            // by another process) ends the replay
+            while ((size_t)(end - in) >= RECORD_HEADER) {
+                Entry entry;
+                entry.key.hash = get<uint64_t>(in);
+                entry.key.size = get<uint64_t>(in);
+                entry.key.width = get<uint32_t>(in);
+                entry.key.height = get<uint32_t>(in);
+                entry.result.score = get<int32_t>(in);
+                entry.result.iterations = get<int64_t>(in);
+                entry.result.seed = get<uint64_t>(in);
+                entry.result.seconds = get<double>(in);
+                const uint64_t mines = get<uint64_t>(in);
+                if ((uint64_t)(end - in) / 8 < mines) break;
+                entry.result.mines.resize(mines);
+                for (auto& [x, y] : entry.result.mines) {
+                    x = get<uint32_t>(in);
+                    y = get<uint32_t>(in);
+                }
+                store(move(entry));
+            }
+            torn = in != end;
+            logBytes_ = file.size();
+            replayed = true;
+        }
+    }
+    // The writing process has the file to itself
+    if (readOnly_) return;
+    if (!replayed || torn || logBytes_ > 2 * (FILE_HEADER + liveBytes_)) {
+        compact();
+    } else {
+        log_.open(path_, ios::binary | ios::app);
+    }
+    if (!log_) throw runtime_error("Could not open " + path_);
+}
+
+void ResultCache::compact() {
+    log_.close();
+    const string temporary = path_ + ".tmp";
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        out.write(MAGIC, 4);
+        string header;
+        put(header, VERSION);
+        out.write(header.data(), header.size());
+        for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+            const string data = record(*it);
+            out.write(data.data(), data.size());
+        }
+        if (!out) throw runtime_error("Could not write " + temporary);
+    }
+    // The rename replaces the old file at once, so a crash leaves one of the two
+#ifdef _WIN32
+    // except on Windows, where rename does not replace files
+    remove(path_.c_str());
+#endif
+    if (rename(temporary.c_str(), path_.c_str()) != 0) {
+        throw runtime_error("Could not replace " + path_);
+    }
+    logBytes_ = FILE_HEADER + liveBytes_;
+    log_.open(path_, ios::binary | ios::app);
+}
@@ -0,0 +1,202 @@
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include "scan.hpp"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_X86
+#include <immintrin.h>
+#endif
+
+// Class of a byte which is not a cell
+static const uint8_t NOT_A_CELL = 0xFF;
+
+static const array<uint8_t, 256> CLASS_TABLE = [] {
+    array<uint8_t, 256> table;
+    table.fill(NOT_A_CELL);
+    for (int digit = 0; digit <= 9; digit++) {
+        table['0' + digit] = digit;
+    }
+    table['X'] = CELL_MINE;
+    table['.'] = CELL_UNKNOWN;
+    return table;
+}();
+
+// A kernel classifies the cells at the start of the text until the first byte which is not a cell
+// Returns the number of cells, out gets their classes if it is not null
+// Bytes after the first non cell may be written to out too, but never more than size bytes
+typedef size_t (*ScanSpan)(const char* text, size_t size, uint8_t* out);
+
+static size_t scanScalar(const char* text, size_t size, uint8_t* out) {
+    for (size_t i = 0; i < size; i++) {
+        const uint8_t cls = CLASS_TABLE[(unsigned char)text[i]];
+        if (cls == NOT_A_CELL) return i;
+        if (out != nullptr) out[i] = cls;
+    }
+    return size;
+}
+
+#ifdef SCAN_X86
+__attribute__((target("sse2")))
+static size_t scanSse2(const char* text, size_t size, uint8_t* out) {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i mine = _mm_set1_epi8('X');
+    const __m128i unknown = _mm_set1_epi8('.');
+    const __m128i mineClass = _mm_set1_epi8(CELL_MINE);
+    const __m128i unknownClass = _mm_set1_epi8(CELL_UNKNOWN);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        // Bytes below '0' wrap around, so one unsigned compare checks both ends of the digit range
+        const __m128i value = _mm_sub_epi8(bytes, zero);
+        const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(value, nine), value);
+        const __m128i isMine = _mm_cmpeq_epi8(bytes, mine);
+        const __m128i isUnknown = _mm_cmpeq_epi8(bytes, unknown);
+        const unsigned valid = _mm_movemask_epi8(_mm_or_si128(isDigit, _mm_or_si128(isMine, isUnknown)));
+        if (out != nullptr) {
+            const __m128i classes = _mm_or_si128(
+                _mm_and_si128(isDigit, value),
+                _mm_or_si128(_mm_and_si128(isMine, mineClass), _mm_and_si128(isUnknown, unknownClass)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), classes);
+        }
+        if (valid != 0xFFFF) return i + __builtin_ctz(~valid);
+    }
+    return i + scanScalar(text + i, size - i, out != nullptr ? out + i : nullptr);
+}
+
+__attribute__((target("avx2")))
+static size_t scanAvx2(const char* text, size_t size, uint8_t* out) {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i mine = _mm256_set1_epi8('X');
+    const __m256i unknown = _mm256_set1_epi8('.');
+    const __m256i mineClass = _mm256_set1_epi8(CELL_MINE);
+    const __m256i unknownClass = _mm256_set1_epi8(CELL_UNKNOWN);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const __m256i value = _mm256_sub_epi8(bytes, zero);
+        const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(value, nine), value);
+        const __m256i isMine = _mm256_cmpeq_epi8(bytes, mine);
+        const __m256i isUnknown = _mm256_cmpeq_epi8(bytes, unknown);
+        const uint32_t valid = _mm256_movemask_epi8(_mm256_or_si256(isDigit, _mm256_or_si256(isMine, isUnknown)));
+        if (out != nullptr) {
+            const __m256i classes = _mm256_or_si256(
+                _mm256_and_si256(isDigit, value),
+                _mm256_or_si256(_mm256_and_si256(isMine, mineClass), _mm256_and_si256(isUnknown, unknownClass)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), classes);
+        }
+        if (valid != 0xFFFFFFFFu) return i + __builtin_ctz(~valid);
+    }
+    // The rest is shorter than one AVX2 block
+    return i + scanSse2(text + i, size - i, out != nullptr ? out + i : nullptr);
+}
+#endif
+
+bool scanKernelSupported(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Auto:
+        case ScanKernel::Scalar:
+            return true;
+#ifdef SCAN_X86
+        case ScanKernel::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case ScanKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanKernel bestScanKernel() {
+    static const ScanKernel best = [] {
+        if (scanKernelSupported(ScanKernel::Avx2)) return ScanKernel::Avx2;
+        if (scanKernelSupported(ScanKernel::Sse2)) return ScanKernel::Sse2;
+        return ScanKernel::Scalar;
+    }();
+    return best;
+}
+
+const char* scanKernelName(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Auto: return "auto";
+        case ScanKernel::Scalar: return "scalar";
+        case ScanKernel::Sse2: return "sse2";
+        case ScanKernel::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+static ScanSpan spanFor(ScanKernel kernel) {
+    if (kernel == ScanKernel::Auto) kernel = bestScanKernel();
+    if (!scanKernelSupported(kernel)) {
+        throw invalid_argument(string("Scan kernel not supported on this CPU: ") + scanKernelName(kernel));
+    }
+    switch (kernel) {
+#ifdef SCAN_X86
+        case ScanKernel::Sse2: return scanSse2;
+        case ScanKernel::Avx2: return scanAvx2;
+#endif
+        default: return scanScalar;
+    }
+}
+
+// A "---" line, the rest of the text is not part of the board
+static bool separatorAt(const char* text, size_t size) {
+    if (size < 3 || memcmp(text, "---", 3) != 0) return false;
+    if (size == 3 || text[3] == '\n') return true;
+    return text[3] == '\r' && (size == 4 || text[4] == '\n');
+}
+
+static string describe(char c) {
+    if (isprint((unsigned char)c)) return string("'") + c + "'";
+    static const char* hex = "0123456789abcdef";
+    return string("byte 0x") + hex[(unsigned char)c >> 4] + hex[c & 15];
+}
+
+ScannedBoard scanBoard(const char* data, size_t size, bool classify, ScanKernel kernel) {
+    const ScanSpan scan = spanFor(kernel);
+    ScannedBoard board;
+    board.view.width = 0;
+    // There are never more cells than bytes, so a kernel can not write past the end
+    if (classify) board.cells.resize(size);
+    size_t cellCount = 0;
+    size_t lineStart = 0;
+    size_t line = 1;
+    while (lineStart < size) {
+        uint8_t* out = classify ? board.cells.data() + cellCount : nullptr;
+        const size_t end = lineStart + scan(data + lineStart, size - lineStart, out);
+        size_t next = end;
+        if (end < size) {
+            const char c = data[end];
+            if (c == '\n') {
+                next = end + 1;
+            } else if (c == '\r' && (end + 1 == size || data[end + 1] == '\n')) {
+                next = end + 2;
+            } else if (end == lineStart && separatorAt(data + end, size - end)) {
+                break;
+            } else {
+                throw runtime_error("Unexpected character " + describe(c) + " at line " + to_string(line)
+                    + ", column " + to_string(end - lineStart + 1));
+            }
+        }
+        const size_t length = end - lineStart;
+        if (length > 0) {
+            if (board.view.rows.empty()) {
+                board.view.width = length;
+            } else if (length != (size_t)board.view.width) {
+                throw runtime_error("Inconsistent row width! Line " + to_string(line) + " has "
+                    + to_string(length) + " cells instead of " + to_string(board.view.width));
+            }
+            board.view.rows.push_back(data + lineStart);
+            cellCount += length;
+        }
+        lineStart = next;
+        line++;
+    }
+    board.view.height = board.view.rows.size();
+    if (classify) board.cells.resize(cellCount);
+    return board;
+}
@@ -0,0 +1,151 @@
+#include <deque>
+#include <stdexcept>
+#include "stream.hpp"
+#include "arena.hpp"
+
+// Reads the rows of a board one at a time, with the same rules as scanBoard
+struct RowReader {
+    istream& in;
+    int line = 0;
+    int width = 0;
+    bool ended = false;
+
+    explicit RowReader(istream& in) : in(in) {}
+
+    // The next row into row, false at the end of the board
+    // Throws runtime_error on a malformed character or an uneven row
+    bool next(string& row) {
+        while (!ended && getline(in, row)) {
+            line++;
+            if (!row.empty() && row.back() == '\r') row.pop_back();
+            if (row.empty()) continue;
+            if (row == "---") break;
+            for (size_t x = 0; x < row.size(); x++) {
+                const char c = row[x];
+                if ((c < '0' || c > '9') && c != 'X' && c != '.') {
+                    throw runtime_error("Unexpected character at line " + to_string(line) + ", column " + to_string(x + 1));
+                }
+            }
+            if (width == 0) {
+                width = row.size();
+            } else if ((int)row.size() != width) {
+                throw runtime_error("Inconsistent row width! Line " + to_string(line) + " has "
+                    + to_string(row.size()) + " cells instead of " + to_string(width));
+            }
+            return true;
+        }
+        ended = true;
+        return false;
+    }
+};
+
+// Error of the counts of the row, above and below are nullptr at the edges of the board
+static int rowError(const string* above, const string& row, const string* below) {
+    const int width = row.size();
+    int total = 0;
+    for (int x = 0; x < width; x++) {
+        if (row[x] < '0' || row[x] > '9') continue;
+        int armed = 0;
+        for (const string* neighbors : {above, &row, below}) {
+            if (neighbors == nullptr) continue;
+            for (int nx = max(0, x - 1); nx <= min(width - 1, x + 1); nx++) {
+                armed += (*neighbors)[nx] == 'X';
+            }
+        }
+        total += abs(row[x] - '0' - armed);
+    }
+    return total;
+}
+
+// Solve the pending rows below the final ones, with the final rows fixed
+// solved holds the solution of the carried rows from the band before, they start from it, and gets the solution of every pending row
+static long long solveBand(const deque<string>& final, const vector<string>& pending, vector<string>& solved,
+                           const LahcOptions& options, const StreamOptions& stream, uint64_t streamIndex, Arena& arena) {
+    // Two final rows are enough, the counts of the last one need the one above it
+    const int context = min<int>(2, final.size());
+    BoardView view;
+    view.width = pending[0].size();
+    view.height = context + pending.size();
+    for (int y = 0; y < context; y++) {
+        view.rows.push_back(final[final.size() - context + y].data());
+    }
+    for (const string& row : pending) {
+        view.rows.push_back(row.data());
+    }
+    Graph graph = fromBoard(view, &arena);
+    Rng rng(options.seed, streamIndex);
+    initialFill(graph, options.init, rng);
+    for (auto& [key, bomb] : graph.bombs) {
+        if (bomb.y < context) {
+            bomb.armed = view.rows[bomb.y][bomb.x] == 'X';
+        } else if (bomb.y - context < (int)solved.size()) {
+            bomb.armed = solved[bomb.y - context][bomb.x] == 'X';
+        }
+    }
+    SolverState state = buildSolverState(graph);
+    // Only the bombs of the pending rows get flipped
+    vector<int> candidates;
+    for (size_t bit = 0; bit < state.bombKeys.size(); bit++) {
+        if ((int)(state.bombKeys[bit] & 0xffffffff) >= context) candidates.push_back(bit);
+    }
+    long long iterations = 0;
+    if (!candidates.empty()) {
+        LahcOptions local = options;
+        local.onImprove = nullptr;
+        local.onPhase = nullptr;
+        local.lnsPeriod = 0;
+        scaleBudget(local, candidates.size(), stream.iterationsPerBomb, stream.toMemory);
+        iterations = lahcSearch(graph, state, local, rng, &candidates);
+        applySolution(graph, state, state.current);
+    }
+    solved = pending;
+    for (const auto& [key, bomb] : graph.bombs) {
+        if (bomb.y >= context) solved[bomb.y - context][bomb.x] = bomb.armed ? 'X' : '.';
+    }
+    return iterations;
+}
+
+StreamResult streamFill(istream& in, const LahcOptions& options, const StreamOptions& stream, const RowSink& emit) {
+    if (stream.band < 1 || stream.carry < 0 || stream.carry >= stream.band) {
+        throw invalid_argument("A band of " + to_string(stream.band) + " rows can not carry " + to_string(stream.carry) + " rows");
+    }
+    StreamResult result;
+    RowReader reader(in);
+    deque<string> final; // the last final rows, the counts of a row get scored once the row below it is final
+    vector<string> pending; // rows which are not final yet, as they were read
+    vector<string> solved; // solution of the pending rows
+    // Every band rewinds the arena, so it stops growing once it fits the largest band
+    Arena arena;
+    // Every band has its own stream, like the tiles
+    const uint64_t streams = options.stream * 0x100000000ULL + 1;
+    bool more = true;
+    string row;
+    while (more) {
+        while ((int)pending.size() < stream.band && (more = reader.next(row))) {
+            pending.push_back(move(row));
+        }
+        if (pending.empty()) break;
+        arena.reset();
+        result.iterations += solveBand(final, pending, solved, options, stream, streams + result.bands, arena);
+        result.bands++;
+        // At the end of the board there is nothing left to carry
+        const int done = more ? pending.size() - stream.carry : pending.size();
+        for (int i = 0; i < done; i++) {
+            emit(result.rows, solved[i], pending[i]);
+            final.push_back(move(solved[i]));
+            if (final.size() >= 2) {
+                result.score += rowError(final.size() == 3 ? &final[0] : nullptr, final[final.size() - 2], &final.back());
+            }
+            if (final.size() == 3) final.pop_front();
+            result.rows++;
+        }
+        pending.erase(pending.begin(), pending.begin() + done);
+        solved.erase(solved.begin(), solved.begin() + done);
+    }
+    // The last row has no row below it
+    if (!final.empty()) {
+        result.score += rowError(final.size() == 2 ? &final[0] : nullptr, final.back(), nullptr);
+    }
+    result.width = reader.width;
+    return result;
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <barrier>
+#include <thread>
+#include "sweep.hpp"
+#include "core.hpp"
+#include "telemetry.hpp"
+
+Coloring::Coloring(pmr::memory_resource* memory)
+    : color(memory),
+      classStart(memory),
+      classBits(memory) {}
+
+Coloring colorBits(const SolverState& state, const vector<int>* bits) {
+    pmr::memory_resource* memory = state.bombKeys.get_allocator().resource();
+    Coloring coloring(memory);
+    const int bitAmount = state.bombKeys.size();
+    const int colored = bits != nullptr ? bits->size() : bitAmount;
+    coloring.color.assign(bitAmount, -1);
+    // taken[c] == bit if a neighbor of bit has color c
+    pmr::vector<int> taken(memory);
+    for (int i = 0; i < colored; i++) {
+        const int bit = bits != nullptr ? (*bits)[i] : i;
+        for (int slot = 0; slot < MAX_DEGREE; slot++) {
+            const int count = state.bitsetImpactLookup[bit * MAX_DEGREE + slot];
+            if (count == -1) break;
+            for (int j = 0; j < MAX_DEGREE; j++) {
+                const int other = state.countNeighborLookup[count * MAX_DEGREE + j];
+                if (other != -1 && coloring.color[other] != -1) {
+                    taken[coloring.color[other]] = bit;
+                }
+            }
+        }
+        int color = 0;
+        while (color < (int)taken.size() && taken[color] == bit) color++;
+        if (color == (int)taken.size()) taken.push_back(-1);
+        coloring.color[bit] = color;
+    }
+    coloring.colors = taken.size();
+    // Bucket the bits by color
+    coloring.classStart.assign(coloring.colors + 1, 0);
+    for (int color : coloring.color) {
+        if (color != -1) coloring.classStart[color + 1]++;
+    }
+    for (int c = 0; c < coloring.colors; c++) coloring.classStart[c + 1] += coloring.classStart[c];
+    coloring.classBits.resize(colored);
+    pmr::vector<int> fill(coloring.classStart.begin(), coloring.classStart.end() - 1, memory);
+    for (int bit = 0; bit < bitAmount; bit++) {
+        if (coloring.color[bit] != -1) coloring.classBits[fill[coloring.color[bit]]++] = bit;
+    }
+    return coloring;
+}
+
+// What a thread proposed in the current step, the flips are already applied to the count masks
+struct SweepWorker {
+    Rng rng;
+    pmr::vector<int> flipped; // improving and neutral flips
+    pmr::vector<int> uphill; // worsening flips, they get undone if the move is rejected
+    int delta = 0; // of the improving and neutral flips
+    int uphillDelta = 0;
+};
+
+int sweepSearch(const Graph& graph, SolverState& state, const Coloring& coloring, const LahcOptions& options, Rng& rng) {
+    // Bits outside of the classes are never evaluated
+    const int bitAmount = coloring.classBits.size();
+    if (bitAmount == 0) {
+        return 0;
+    }
+    pmr::memory_resource* memory = memoryOf(graph);
+    const int threads = max(1, options.sweepThreads);
+    const int* impacts = state.bitsetImpactLookup.data();
+    // A full sweep evaluates every bit once and takes one move per color
+    const int memorySize = max<long long>(1, (long long)options.scoreMemorySize * coloring.colors / bitAmount);
+    pmr::vector<int> previousScores(memorySize, state.score, memory);
+    int k = 0;
+    int currentScore = state.score;
+    int bestScore = currentScore;
+    TELEMETRY_SET(bestScore, bestScore);
+    if (options.onImprove) {
+        options.onImprove(0, bestScore);
+    }
+    BitSet best(state.current.size(), memory);
+    best = state.current;
+
+    pmr::vector<SweepWorker> workers(memory);
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(SweepWorker{Rng(rng.next()), pmr::vector<int>(memory), pmr::vector<int>(memory), 0, 0});
+    }
+    // Largest part of a class a thread can get
+    int largestClass = 0;
+    for (int c = 0; c < coloring.colors; c++) {
+        largestClass = max(largestClass, coloring.classStart[c + 1] - coloring.classStart[c]);
+    }
+    // The memory of the graph may be an arena, which is not thread-safe, so the threads must never allocate
+    // A thread proposes each bit of its part of a class at most once, which bounds both vectors
+    for (SweepWorker& worker : workers) {
+        worker.flipped.reserve(largestClass / threads + 1);
+        worker.uphill.reserve(largestClass / threads + 1);
+    }
+
+    int iteration = 0;
+    int color = 0;
+    bool done = bestScore == 0 || options.maxIterations <= 0;
+    // Runs on one thread once all of them proposed their flips
+    // Improving and neutral flips can not make the move worse, so only the worsening ones depend on the acceptance
+    auto decide = [&]() noexcept {
+        int delta = 0;
+        int uphillDelta = 0;
+        for (const SweepWorker& worker : workers) {
+            delta += worker.delta;
+            uphillDelta += worker.uphillDelta;
+        }
+        const int newScore = currentScore + delta + uphillDelta;
+        const bool accepted = newScore <= currentScore || newScore <= previousScores[k];
+        TELEMETRY_ADD(iterations, 1);
+        TELEMETRY_ADD(accepted, accepted);
+        TELEMETRY_ADD(rejected, !accepted);
+        TELEMETRY_ADD(neutral, accepted && newScore == currentScore);
+        // The bitset words are shared between the threads, so only the masks got changed in parallel
+        for (SweepWorker& worker : workers) {
+            for (int bit : worker.flipped) state.current.flip(bit);
+            for (int bit : worker.uphill) {
+                if (accepted) {
+                    state.current.flip(bit);
+                } else {
+                    flipMasks(state, impacts, bit);
+                }
+            }
+        }
+        currentScore = accepted ? newScore : currentScore + delta;
+        state.score = currentScore;
+        if (currentScore <= bestScore) {
+            if (currentScore < bestScore && options.onImprove) {
+                options.onImprove(iteration + 1, currentScore);
+            }
+            TELEMETRY_ADD(improvements, currentScore < bestScore);
+            bestScore = currentScore;
+            TELEMETRY_SET(bestScore, bestScore);
+            best = state.current;
+        }
+        previousScores[k] = newScore;
+        k = (k + 1) % memorySize;
+        iteration += coloring.classStart[color + 1] - coloring.classStart[color];
+        color = (color + 1) % coloring.colors;
+        done = bestScore == 0 || iteration >= options.maxIterations;
+        TELEMETRY_TICK();
+    };
+    barrier proposed(threads, decide);
+
+    auto work = [&](int t) {
+        SweepWorker& worker = workers[t];
+        while (!done) {
+            const int first = coloring.classStart[color];
+            const int size = coloring.classStart[color + 1] - first;
+            const int* bits = coloring.classBits.data() + first;
+            worker.flipped.clear();
+            worker.uphill.clear();
+            worker.delta = 0;
+            worker.uphillDelta = 0;
+            // Same colored bits share no count, so every thread only touches the masks of its own counts
+            for (int i = (long long)size * t / threads; i < (long long)size * (t + 1) / threads; i++) {
+                const int bit = bits[i];
+                const int delta = flipScoreImpact(state, impacts, bit);
+                if (delta < 0 || (delta == 0 && worker.rng.below(2))) {
+                    flipMasks(state, impacts, bit);
+                    worker.flipped.push_back(bit);
+                    worker.delta += delta;
+                } else if (delta > 0 && worker.rng.below(size) == 0) {
+                    flipMasks(state, impacts, bit);
+                    worker.uphill.push_back(bit);
+                    worker.uphillDelta += delta;
+                }
+            }
+            proposed.arrive_and_wait();
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (thread& worker : pool) {
+        worker.join();
+    }
+    // decide ran on any of the threads, the workers handed their counts over when they exited
+    TELEMETRY_SET(bestScore, bestScore);
+    TELEMETRY_SNAPSHOT("end");
+    // End up in the best solution found
+    restoreSolution(state, best);
+    return iteration;
+}
@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "telemetry.hpp"
+
+// Everything shared between the threads is behind the mutex
+// The threads only take it when they publish, which is once per snapshot
+static mutex telemetryMutex;
+static FILE* sink = nullptr;
+static uint64_t every = 0;
+static uint64_t startNs = 0;
+static vector<TelemetryCounters> published; // latest counters of every thread
+static vector<size_t> freeSlots; // slots in published of threads which exited
+static TelemetryCounters retired; // sum of the threads which exited, without a best score
+
+// Add the counts of counters to total, the best score is the lowest known one
+static void addCounters(TelemetryCounters& total, const TelemetryCounters& counters) {
+    total.iterations += counters.iterations;
+    total.accepted += counters.accepted;
+    total.rejected += counters.rejected;
+    total.neutral += counters.neutral;
+    total.improvements += counters.improvements;
+    total.lnsSteps += counters.lnsSteps;
+    total.selectNs += counters.selectNs;
+    total.deltaNs += counters.deltaNs;
+    if (counters.bestScore != -1 && (total.bestScore == -1 || counters.bestScore < total.bestScore)) {
+        total.bestScore = counters.bestScore;
+    }
+}
+
+struct LocalTelemetry {
+    TelemetryCounters counters;
+    size_t slot; // index in published
+    uint64_t nextSnapshot;
+
+    LocalTelemetry() {
+        lock_guard<mutex> lock(telemetryMutex);
+        if (freeSlots.empty()) {
+            slot = published.size();
+            published.emplace_back();
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        nextSnapshot = every;
+    }
+
+    // A thread which exits hands its counts over, e.g. a sweep worker which ran the acceptance of the moves,
+    // and its slot gets reused, so the short lived threads of sweeps and tiles do not pile up
+    // Its best score belonged to a search which is over, that one gets published by the thread which ran the search
+    ~LocalTelemetry() {
+        lock_guard<mutex> lock(telemetryMutex);
+        counters.bestScore = -1;
+        addCounters(retired, counters);
+        published[slot] = TelemetryCounters();
+        freeSlots.push_back(slot);
+    }
+};
+
+static thread_local LocalTelemetry local;
+
+uint64_t telemetryNow() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool telemetryConfigure(const string& path, uint64_t snapshotEvery) {
+    lock_guard<mutex> lock(telemetryMutex);
+    if (sink != nullptr && sink != stderr) {
+        fclose(sink);
+    }
+    sink = path.empty() ? nullptr : path == "-" ? stderr : fopen(path.c_str(), "a");
+    every = snapshotEvery;
+    startNs = telemetryNow();
+    return path.empty() || sink != nullptr;
+}
+
+bool telemetryCompiled() {
+#ifdef SWEEPER_TELEMETRY
+    return true;
+#else
+    return false;
+#endif
+}
+
+TelemetryCounters& telemetryLocal() {
+    return local.counters;
+}
+
+static TelemetryCounters sumPublished() {
+    TelemetryCounters total = retired;
+    for (const TelemetryCounters& counters : published) {
+        addCounters(total, counters);
+    }
+    return total;
+}
+
+TelemetryCounters telemetryTotal() {
+    // The first use of local registers it, which takes the mutex, so it has to happen before locking
+    LocalTelemetry& mine = local;
+    lock_guard<mutex> lock(telemetryMutex);
+    published[mine.slot] = mine.counters;
+    return sumPublished();
+}
+
+void telemetrySnapshot(const char* event) {
+    LocalTelemetry& mine = local;
+    lock_guard<mutex> lock(telemetryMutex);
+    published[mine.slot] = mine.counters;
+    if (sink == nullptr) return;
+    TelemetryCounters total = sumPublished();
+    double seconds = (telemetryNow() - startNs) / 1e9;
+    double moves = total.accepted + total.rejected;
+    fprintf(sink,
+        "{\"event\":\"%s\",\"seconds\":%.6f,\"threads\":%zu,\"iterations\":%llu,\"iterations_per_sec\":%.0f,"
+        "\"accepted\":%llu,\"rejected\":%llu,\"neutral\":%llu,\"acceptance_rate\":%.4f,\"improvements\":%llu,"
+        "\"lns_steps\":%llu,\"select_ns\":%llu,\"delta_ns\":%llu,\"best\":%d}\n",
+        event, seconds, published.size() - freeSlots.size(), (unsigned long long)total.iterations,
+        seconds > 0 ? total.iterations / seconds : 0.0,
+        (unsigned long long)total.accepted, (unsigned long long)total.rejected, (unsigned long long)total.neutral,
+        moves > 0 ? total.accepted / moves : 0.0, (unsigned long long)total.improvements,
+        (unsigned long long)total.lnsSteps, (unsigned long long)total.selectNs, (unsigned long long)total.deltaNs,
+        total.bestScore);
+    fflush(sink);
+}
+
+void telemetryTick() {
+    if (every == 0 || local.counters.iterations < local.nextSnapshot) return;
+    local.nextSnapshot = local.counters.iterations + every;
+    telemetrySnapshot("tick");
+}
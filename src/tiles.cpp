@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "tiles.hpp"
+#include "arena.hpp"
+
+// Cells of the board between x0 and x1 and between y0 and y1, the ends are exclusive
+struct Rect {
+    int x0, y0, x1, y1;
+};
+
+// The rect grown by margin on every side, cut off at the board
+static Rect grow(const Rect& rect, int margin, int width, int height) {
+    return {max(0, rect.x0 - margin), max(0, rect.y0 - margin), min(width, rect.x1 + margin), min(height, rect.y1 + margin)};
+}
+
+static bool inside(const Rect& rect, int x, int y) {
+    return x >= rect.x0 && x < rect.x1 && y >= rect.y0 && y < rect.y1;
+}
+
+// The rows of the board inside the rect, the graph of it has coordinates relative to the rect
+static BoardView viewOf(const BoardView& board, const Rect& rect) {
+    BoardView view;
+    view.width = rect.x1 - rect.x0;
+    view.height = rect.y1 - rect.y0;
+    view.rows.reserve(view.height);
+    for (int y = rect.y0; y < rect.y1; y++) {
+        view.rows.push_back(board.rows[y] + rect.x0);
+    }
+    return view;
+}
+
+// Run the task for every index with the given number of threads
+static void forEach(int amount, int threads, const function<void(int index, Arena& arena)>& task) {
+    atomic<int> next{0};
+    auto work = [&]() {
+        // The arena lives as long as the worker, every task rewinds it
+        Arena arena;
+        for (int index = next++; index < amount; index = next++) {
+            arena.reset();
+            task(index, arena);
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < min(threads, amount); t++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (thread& worker : pool) {
+        worker.join();
+    }
+}
+
+int planeErrorScore(const CellPlane& plane) {
+    int total = 0;
+    for (int y = 0; y < plane.height; y++) {
+        for (int x = 0; x < plane.width; x++) {
+            const int target = plane.cells[(size_t)y * plane.width + x];
+            if (target > 9) continue;
+            int armed = 0;
+            for (int ny = max(0, y - 1); ny <= min(plane.height - 1, y + 1); ny++) {
+                for (int nx = max(0, x - 1); nx <= min(plane.width - 1, x + 1); nx++) {
+                    armed += plane.cells[(size_t)ny * plane.width + nx] == CELL_MINE;
+                }
+            }
+            total += abs(target - armed);
+        }
+    }
+    return total;
+}
+
+// Options of a search inside a worker, the callbacks of the caller are not safe to call from there
+static LahcOptions workerOptions(const LahcOptions& options, const TileOptions& tiles, int bombs, uint64_t stream) {
+    LahcOptions local = options;
+    local.onImprove = nullptr;
+    local.onPhase = nullptr;
+    local.stream = stream;
+    scaleBudget(local, bombs, tiles.iterationsPerBomb, tiles.toMemory);
+    return local;
+}
+
+// Solve a tile with its overlap and write its interior into the plane
+static long long solveTile(const BoardView& board, const Rect& interior, const LahcOptions& options, const TileOptions& tiles,
+                           uint64_t stream, CellPlane& plane, Arena& arena) {
+    const Rect area = grow(interior, tiles.overlap, board.width, board.height);
+    Graph graph = fromBoard(viewOf(board, area), &arena);
+    const long long iterations = lahcFill(graph, workerOptions(options, tiles, graph.bombs.size(), stream));
+    for (const auto& [key, bomb] : graph.bombs) {
+        const int x = area.x0 + bomb.x;
+        const int y = area.y0 + bomb.y;
+        if (inside(interior, x, y)) {
+            plane.cells[(size_t)y * plane.width + x] = bomb.armed ? CELL_MINE : CELL_UNKNOWN;
+        }
+    }
+    return iterations;
+}
+
+// Repair the violated counts inside the band, only bombs inside the band grown by the seam get flipped
+// Returns the iterations, -1 if nothing was violated
+static long long repairBand(const BoardView& board, const Rect& band, const LahcOptions& options, const TileOptions& tiles,
+                            uint64_t stream, CellPlane& plane, Arena& arena) {
+    const Rect writable = grow(band, tiles.seam, board.width, board.height);
+    // The counts of the freed bombs are at most one cell further out, and they need all of their neighbors
+    const Rect area = grow(writable, 2, board.width, board.height);
+    Graph graph = fromBoard(viewOf(board, area), &arena);
+    for (auto& [key, bomb] : graph.bombs) {
+        bomb.armed = plane.cells[(size_t)(area.y0 + bomb.y) * plane.width + area.x0 + bomb.x] == CELL_MINE;
+    }
+    SolverState state = buildSolverState(graph);
+    // Free the bombs near the violated counts of the band
+    pmr::vector<char> freed(state.bombKeys.size(), 0, &arena);
+    for (size_t i = 0; i < graph.counts.size(); i++) {
+        const Count& count = graph.counts[i];
+        if (countError(state, i) == 0 || !inside(band, area.x0 + count.x, area.y0 + count.y)) continue;
+        for (int y = count.y - tiles.seam; y <= count.y + tiles.seam; y++) {
+            for (int x = count.x - tiles.seam; x <= count.x + tiles.seam; x++) {
+                auto it = state.bombIndexMap.find(bombKey(x, y));
+                if (it != state.bombIndexMap.end() && inside(writable, area.x0 + x, area.y0 + y)) {
+                    freed[it->second] = 1;
+                }
+            }
+        }
+    }
+    vector<int> candidates;
+    for (size_t bit = 0; bit < freed.size(); bit++) {
+        if (freed[bit]) candidates.push_back(bit);
+    }
+    if (candidates.empty()) {
+        return -1;
+    }
+    LahcOptions local = workerOptions(options, tiles, candidates.size(), stream);
+    // The window steps would free bombs outside of the candidates
+    local.lnsPeriod = 0;
+    Rng rng(local.seed, local.stream);
+    const long long iterations = lahcSearch(graph, state, local, rng, &candidates);
+    for (int bit : candidates) {
+        const i64 key = state.bombKeys[bit];
+        const int x = area.x0 + (int)(key >> 32);
+        const int y = area.y0 + (int)(key & 0xffffffff);
+        plane.cells[(size_t)y * plane.width + x] = state.current.test(bit) ? CELL_MINE : CELL_UNKNOWN;
+    }
+    return iterations;
+}
+
+TiledResult tiledFill(const BoardView& board, const LahcOptions& options, const TileOptions& tiles) {
+    // Repairs of neighboring seams run at the same time, so what they read and write must not meet
+    if (tiles.size < 4 * tiles.seam + 6 || tiles.overlap < 0 || tiles.seam < 0) {
+        throw invalid_argument("Tiles of size " + to_string(tiles.size) + " are too small for a seam of " + to_string(tiles.seam));
+    }
+    const int threads = tiles.threads > 0 ? tiles.threads : max(1u, thread::hardware_concurrency());
+    TiledResult result;
+    result.plane = planeOf(board);
+    const int columns = (board.width + tiles.size - 1) / tiles.size;
+    const int rows = (board.height + tiles.size - 1) / tiles.size;
+    result.tiles = columns * rows;
+    // Every tile and seam piece has its own stream, the pieces get numbered after the tiles
+    uint64_t streams = options.stream * 0x100000000ULL + 1;
+    atomic<long long> iterations{0};
+    atomic<int> repairs{0};
+    forEach(result.tiles, threads, [&](int index, Arena& arena) {
+        const int x0 = index % columns * tiles.size;
+        const int y0 = index / columns * tiles.size;
+        const Rect interior{x0, y0, min(board.width, x0 + tiles.size), min(board.height, y0 + tiles.size)};
+        iterations += solveTile(board, interior, options, tiles, streams + index, result.plane, arena);
+    });
+    streams += result.tiles;
+    // The vertical seams first, every task goes down one seam piece by piece, then the same for the horizontal ones
+    for (int vertical = 1; vertical >= 0; vertical--) {
+        const int lines = vertical ? columns - 1 : rows - 1;
+        const int pieces = vertical ? rows : columns;
+        forEach(lines, threads, [&](int line, Arena& arena) {
+            const int at = (line + 1) * tiles.size;
+            for (int piece = 0; piece < pieces; piece++) {
+                const int from = piece * tiles.size;
+                const Rect band = vertical
+                    ? Rect{at - tiles.seam, from, at + tiles.seam, min(board.height, from + tiles.size)}
+                    : Rect{from, at - tiles.seam, min(board.width, from + tiles.size), at + tiles.seam};
+                arena.reset();
+                const long long repaired = repairBand(board, grow(band, 0, board.width, board.height), options, tiles,
+                                                      streams + (uint64_t)line * pieces + piece, result.plane, arena);
+                if (repaired >= 0) {
+                    iterations += repaired;
+                    repairs++;
+                }
+            }
+        });
+        streams += (uint64_t)lines * pieces;
+    }
+    result.iterations = iterations;
+    result.repairs = repairs;
+    result.score = planeErrorScore(result.plane);
+    return result;
+}
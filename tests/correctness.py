@@ -1,8 +1,11 @@
+import argparse
 import subprocess
 import random
 import statistics
 
-def generate_board(n=10, m=10, chance=0.4):
+# hints is the chance that a mine is already marked with X in the input,
+# which allows to measure how much the warm starts help
+def generate_board(n=10, m=10, chance=0.4, hints=0.0):
     mines = [[random.random() < chance for _ in range(m)] for _ in range(n)]
     board = []
     mine_count = 0
@@ -10,7 +13,7 @@ def generate_board(n=10, m=10, chance=0.4):
         row = []
         for j in range(m):
             if mines[i][j]:
-                row.append(".")
+                row.append("X" if random.random() < hints else ".")
                 mine_count += 1
             else:
                 count = 0
@@ -28,9 +31,9 @@ def generate_board(n=10, m=10, chance=0.4):
 def board_to_str(board):
     return "\n".join("".join(row) for row in board)
 
-def run_sweeper(board_str):
+def run_sweeper(board_str, sweeper_args):
     proc = subprocess.Popen(
-        ["./bin/sweeper"],
+        ["./bin/sweeper"] + sweeper_args,
         stdin=subprocess.PIPE,
         stdout=subprocess.PIPE,
         stderr=subprocess.PIPE,
@@ -49,27 +52,42 @@ def parse_lahc_score(output):
                     return int(token)
     return None
 
+def parse_iterations(output):
+    for line in output.splitlines():
+        if line.startswith("Iterations:"):
+            return int(line.split()[1])
+    return None
+
 def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--hints", type=float, default=0.0,
+                        help="chance that a mine is marked with X in the input")
+    args, sweeper_args = parser.parse_known_args()
     attempts = 20
     for size in range(10, 61, 10):
-        board, mine_count = generate_board(size, size, chance=0.1)
+        board, mine_count = generate_board(size, size, chance=0.1, hints=args.hints)
         board_str = board_to_str(board)
 
         scores = []
+        iterations = []
         for _ in range(attempts):
-            stdout, stderr = run_sweeper(board_str)
+            stdout, stderr = run_sweeper(board_str, sweeper_args)
             if stderr:
                 print(f"Board {size}x{size} error: {stderr}")
             score = parse_lahc_score(stdout)
             if score is not None:
                 scores.append(score)
+            iteration_count = parse_iterations(stdout)
+            if iteration_count is not None:
+                iterations.append(iteration_count)
         print("Scores:", scores)
         if scores:
             avg_score = statistics.mean(scores)
             score_per_mine = avg_score / mine_count if mine_count > 0 else 0
             print(f"Board {size}x{size}: "
                   f"Avg LAHC score = {avg_score:.2f}, "
-                  f"Avg score per mine = {score_per_mine:.4f}")
+                  f"Avg score per mine = {score_per_mine:.4f}, "
+                  f"Avg iterations = {statistics.mean(iterations) if iterations else 0:.0f}")
         else:
             print(f"Board {size}x{size}: No scores found")
 
@@ -1,35 +1,25 @@
 import subprocess
-import random
+import sys
 import time
 import statistics
 
-def generate_board(n=10, m=10, chance=0.2):
-    mines = [[random.random() < chance for _ in range(m)] for _ in range(n)]
-    board = []
-    for i in range(n):
-        row = []
-        for j in range(m):
-            if mines[i][j]:
-                row.append(".")
-            else:
-                count = 0
-                for di in (-1, 0, 1):
-                    for dj in (-1, 0, 1):
-                        if di == 0 and dj == 0:
-                            continue
-                        ni, nj = i + di, j + dj
-                        if 0 <= ni < n and 0 <= nj < m and mines[ni][nj]:
-                            count += 1
-                row.append(str(count) if count > 0 else ".")
-        board.append(row)
-    return board
-
-def board_to_str(board):
-    return "\n".join("".join(row) for row in board)
+# Boards come from the native generator with a fixed seed per size,
+# so the timings of different runs are comparable
+def generate_board(n=10, m=10, chance=0.2, seed=1):
+    proc = subprocess.run(
+        ["./bin/genboard", "--width", str(m), "--height", str(n),
+         "--density", str(chance), "--seed", str(seed)],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        text=True,
+        check=True
+    )
+    return proc.stdout
 
+# Any arguments of the script get passed to the sweeper, e.g. --init basic
 def run_sweeper(board_str):
     proc = subprocess.Popen(
-        ["./bin/sweeper"],
+        ["./bin/sweeper"] + sys.argv[1:],
         stdin=subprocess.PIPE,
         stdout=subprocess.PIPE,
         stderr=subprocess.PIPE,
@@ -43,8 +33,7 @@ def run_sweeper(board_str):
 def main():
     trials = 3
     for size in range(10, 101, 10):
-        board = generate_board(size, size, chance=0.1)
-        board_str = board_to_str(board)
+        board_str = generate_board(size, size, chance=0.1, seed=size)
 
         times = []
         for _ in range(trials):
@@ -0,0 +1,239 @@
+// Anytime quality and time to target of solver configurations
+// Every configuration runs with the same seeds on the same generated boards,
+// the best score gets recorded against elapsed time and iterations
+// The summary of every configuration is written to stdout as JSON lines
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "generator.hpp"
+#include "optimization.hpp"
+
+using namespace std;
+
+struct Config {
+    string name;
+    LahcOptions options;
+    int k = 50; // iterations per bomb
+    float toMemory = 0.25f; // share of the iterations in the score memory
+};
+
+struct TracePoint {
+    double seconds;
+    int iteration;
+    int best;
+};
+
+struct Run {
+    vector<TracePoint> trace;
+    double seconds; // total time of the run
+};
+
+static void usage() {
+    cerr << "Usage: anytime [--sizes 32,64] [--boards N] [--runs N] [--target T] [--trace FILE]\n"
+         << "               [--config name:k=50,memory=0.25,lns=0,window=5,sweep=0,init=random] ..." << endl;
+}
+
+// name:key=value,key=value
+static Config parseConfig(const string& text) {
+    Config config;
+    size_t colon = text.find(':');
+    config.name = text.substr(0, colon);
+    if (colon == string::npos) return config;
+    stringstream pairs(text.substr(colon + 1));
+    string pair;
+    while (getline(pairs, pair, ',')) {
+        size_t equals = pair.find('=');
+        if (equals == string::npos) throw invalid_argument("Expected key=value: " + pair);
+        string key = pair.substr(0, equals);
+        string value = pair.substr(equals + 1);
+        if (key == "k") {
+            config.k = stoi(value);
+        } else if (key == "memory") {
+            config.toMemory = stof(value);
+        } else if (key == "lns") {
+            config.options.lnsPeriod = stoi(value);
+        } else if (key == "window") {
+            config.options.lnsWindow = stoi(value);
+        } else if (key == "sweep") {
+            config.options.sweepThreads = stoi(value);
+        } else if (key == "init" && value == "random") {
+            config.options.init = InitStrategy::Random;
+        } else if (key == "init" && value == "basic") {
+            config.options.init = InitStrategy::Basic;
+        } else if (key == "init" && value == "greedy") {
+            config.options.init = InitStrategy::Greedy;
+        } else {
+            throw invalid_argument("Unknown setting: " + pair);
+        }
+    }
+    return config;
+}
+
+static Run solve(const Board& board, const Config& config, uint64_t seed) {
+    using clock = chrono::steady_clock;
+    Run run;
+    Graph graph = fromBoard(board);
+    LahcOptions options = config.options;
+    scaleBudget(options, graph.bombs.size(), config.k, config.toMemory);
+    options.seed = seed;
+    auto start = clock::now();
+    options.onImprove = [&](int iteration, int best) {
+        double seconds = chrono::duration<double>(clock::now() - start).count();
+        run.trace.push_back({seconds, iteration, best});
+    };
+    lahcFill(graph, options);
+    run.seconds = chrono::duration<double>(clock::now() - start).count();
+    // Without bombs there is no search, the score is the same from the start
+    if (run.trace.empty()) run.trace.push_back({0, 0, errorScore(graph)});
+    return run;
+}
+
+// Best score at the given time, runs hold their last best after they finished
+static int bestAt(const Run& run, double seconds) {
+    int best = run.trace.front().best;
+    for (const TracePoint& point : run.trace) {
+        if (point.seconds > seconds) break;
+        best = point.best;
+    }
+    return best;
+}
+
+// Area under the best score curve up to the horizon, divided by the horizon
+// Lower is better, it rewards getting good fast and not only ending up good
+static double normalizedArea(const Run& run, double horizon) {
+    if (horizon <= 0) return run.trace.back().best;
+    double area = 0;
+    for (size_t i = 0; i < run.trace.size(); i++) {
+        // The initial score also covers the time spent before the search started
+        double from = i == 0 ? 0 : min(run.trace[i].seconds, horizon);
+        double to = i + 1 < run.trace.size() ? min(run.trace[i + 1].seconds, horizon) : horizon;
+        area += run.trace[i].best * (to - from);
+    }
+    return area / horizon;
+}
+
+static double percentile(vector<double> values, double p) {
+    if (values.empty()) return -1;
+    sort(values.begin(), values.end());
+    return values[min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5))];
+}
+
+int main(int argc, char** argv) {
+    vector<int> sizes = {32, 64};
+    int boards = 3;
+    int runs = 10;
+    int target = 0;
+    string tracePath;
+    vector<Config> configs;
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (i + 1 >= argc) {
+                usage();
+                return 1;
+            }
+            string value = argv[++i];
+            if (arg == "--sizes") {
+                sizes.clear();
+                stringstream list(value);
+                string size;
+                while (getline(list, size, ',')) sizes.push_back(stoi(size));
+            } else if (arg == "--boards") {
+                boards = stoi(value);
+            } else if (arg == "--runs") {
+                runs = stoi(value);
+            } else if (arg == "--target") {
+                target = stoi(value);
+            } else if (arg == "--trace") {
+                tracePath = value;
+            } else if (arg == "--config") {
+                configs.push_back(parseConfig(value));
+            } else {
+                usage();
+                return 1;
+            }
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    if (configs.empty()) {
+        configs.push_back(parseConfig("default"));
+        configs.push_back(parseConfig("lns:lns=20"));
+        configs.push_back(parseConfig("greedy:init=greedy"));
+    }
+    ofstream trace;
+    if (!tracePath.empty()) trace.open(tracePath);
+
+    // runs[config][board][seed]
+    vector<vector<vector<Run>>> results(configs.size());
+    vector<double> horizons;
+    for (int size : sizes) {
+        for (int b = 0; b < boards; b++) {
+            GeneratorOptions generator;
+            generator.width = size;
+            generator.height = size;
+            generator.seed = size * 1000 + b;
+            Board board = generateBoard(generator).board;
+            double horizon = 0;
+            for (size_t c = 0; c < configs.size(); c++) {
+                results[c].emplace_back();
+                for (int seed = 1; seed <= runs; seed++) {
+                    Run run = solve(board, configs[c], seed);
+                    horizon = max(horizon, run.seconds);
+                    if (trace.is_open()) {
+                        for (const TracePoint& point : run.trace) {
+                            trace << "{\"config\":\"" << configs[c].name << "\",\"size\":" << size
+                                  << ",\"board\":" << b << ",\"seed\":" << seed
+                                  << ",\"seconds\":" << point.seconds << ",\"iteration\":" << point.iteration
+                                  << ",\"best\":" << point.best << "}\n";
+                        }
+                    }
+                    results[c].back().push_back(run);
+                }
+            }
+            // All configurations get compared up to the same time on a board
+            horizons.push_back(horizon);
+        }
+    }
+
+    for (size_t c = 0; c < configs.size(); c++) {
+        vector<double> timeToTarget;
+        vector<double> iterationsToTarget;
+        double area = 0;
+        double finalBest = 0;
+        double halfwayBest = 0;
+        int total = 0;
+        for (size_t b = 0; b < results[c].size(); b++) {
+            for (const Run& run : results[c][b]) {
+                total++;
+                area += normalizedArea(run, horizons[b]);
+                finalBest += run.trace.back().best;
+                halfwayBest += bestAt(run, horizons[b] / 2);
+                for (const TracePoint& point : run.trace) {
+                    if (point.best <= target) {
+                        timeToTarget.push_back(point.seconds);
+                        iterationsToTarget.push_back(point.iteration);
+                        break;
+                    }
+                }
+            }
+        }
+        cout << "{\"config\":\"" << configs[c].name << "\""
+             << ",\"runs\":" << total
+             << ",\"target\":" << target
+             << ",\"success_rate\":" << (double)timeToTarget.size() / total
+             << ",\"ttt_median\":" << percentile(timeToTarget, 0.5)
+             << ",\"ttt_p90\":" << percentile(timeToTarget, 0.9)
+             << ",\"iterations_to_target_median\":" << percentile(iterationsToTarget, 0.5)
+             << ",\"mean_area\":" << area / total
+             << ",\"mean_best_halfway\":" << halfwayBest / total
+             << ",\"mean_final_best\":" << finalBest / total
+             << "}" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Generates a board with planted mines
+// The board is written to stdout, the planted solution optionally to a file
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "generator.hpp"
+
+using namespace std;
+
+static void usage() {
+    cerr << "Usage: genboard [--width W] [--height H] [--seed S] [--density D] [--mask M]\n"
+         << "                [--layout uniform|clustered] [--infeasible P] [--solution FILE]" << endl;
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    string solutionPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--width") {
+            options.width = stoi(value);
+        } else if (arg == "--height") {
+            options.height = stoi(value);
+        } else if (arg == "--seed") {
+            options.seed = stoull(value);
+        } else if (arg == "--density") {
+            options.density = stof(value);
+        } else if (arg == "--mask") {
+            options.mask = stof(value);
+        } else if (arg == "--infeasible") {
+            options.infeasible = stof(value);
+        } else if (arg == "--layout" && (value == "uniform" || value == "clustered")) {
+            options.clustered = value == "clustered";
+        } else if (arg == "--solution") {
+            solutionPath = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (options.width <= 0 || options.height <= 0) {
+        cerr << "The board has to have a positive size" << endl;
+        return 1;
+    }
+    ofstream solution;
+    if (!solutionPath.empty()) {
+        solution.open(solutionPath, ios::binary);
+        if (!solution) {
+            cerr << "Could not open " << solutionPath << endl;
+            return 1;
+        }
+    }
+    // Rows are written as they are generated, so the whole board never has to be in memory
+    int plantedError = generateRows(options, [&](const string& row, const string& solutionRow) {
+        fwrite(row.data(), 1, row.size(), stdout);
+        fputc('\n', stdout);
+        if (solution.is_open()) {
+            solution.write(solutionRow.data(), solutionRow.size());
+            solution.put('\n');
+        }
+    });
+    if (solution.is_open()) {
+        solution << "---\n" << "Planted error: " << plantedError << "\n";
+    }
+    cerr << "Planted error: " << plantedError << endl;
+    return 0;
+}
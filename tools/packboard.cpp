@@ -0,0 +1,44 @@
+// Converts boards between the text and the packed format
+// A text board gets packed and a packed board unpacked, from stdin to stdout
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "input.hpp"
+#include "packed.hpp"
+#include "scan.hpp"
+
+using namespace std;
+
+static void usage() {
+    cerr << "Usage: packboard [--uncompressed] < board > converted" << endl;
+}
+
+int main(int argc, char** argv) {
+    bool compress = true;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--uncompressed") {
+            compress = false;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    binaryStream(stdin);
+    binaryStream(stdout);
+    string input = readText(cin);
+    string output;
+    try {
+        if (isPacked(input.data(), input.size())) {
+            output = planeText(unpackPlane(input.data(), input.size()));
+        } else {
+            ScannedBoard scanned = scanBoard(input.data(), input.size(), true);
+            output = packPlane(planeOf(scanned), compress);
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    cout.write(output.data(), output.size());
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "arena.hpp"
+#include "representation.hpp"
+#include "optimization.hpp"
+#include "generator.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+// Every heap allocation of the test runner gets counted, so a test can check that a piece of code does not allocate
+static size_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+    heapAllocations++;
+    if (void* p = malloc(size)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+TEST_CASE("Arena: allocations are aligned and reset keeps the blocks") {
+    Arena arena(64);
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(100, 16);
+    REQUIRE(a != b);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(c) % 16 == 0);
+    REQUIRE(arena.used() == 111);
+    const size_t blocks = arena.heapAllocations();
+    const size_t reserved = arena.reserved();
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    // The same allocations again fit into the kept blocks
+    REQUIRE(arena.allocate(3, 1) == a);
+    REQUIRE(arena.allocate(8, 8) == b);
+    REQUIRE(arena.allocate(100, 16) == c);
+    REQUIRE(arena.heapAllocations() == blocks);
+    REQUIRE(arena.reserved() == reserved);
+}
+
+TEST_CASE("lahcFill: no heap allocations once the arena has grown") {
+    GeneratorOptions generator;
+    generator.width = 40;
+    generator.height = 30;
+    generator.seed = 8;
+    const Board board = generateBoard(generator).board;
+    const BoardView view = viewOf(board);
+    LahcOptions options;
+    options.lnsPeriod = 50;
+    options.seed = 4;
+    Arena arena;
+    int first = 0;
+    {
+        Graph graph = fromBoard(view, &arena);
+        scaleBudget(options, graph.bombs.size());
+        first = lahcFill(graph, options);
+    }
+    arena.reset();
+    const size_t before = heapAllocations;
+    int second = 0;
+    {
+        Graph graph = fromBoard(view, &arena);
+        second = lahcFill(graph, options);
+    }
+    const size_t allocations = heapAllocations - before;
+    REQUIRE(allocations == 0);
+    REQUIRE(second == first);
+}
+
+TEST_CASE("lahcSearch: the search loop does not allocate") {
+    GeneratorOptions generator;
+    generator.width = 30;
+    generator.height = 20;
+    generator.seed = 2;
+    const Graph graph = fromBoard(generateBoard(generator).board);
+    LahcOptions options;
+    options.lnsPeriod = 10;
+    options.scoreMemorySize = 50;
+    // The allocations of a search do not depend on how long it runs
+    auto allocationsOf = [&](int iterations) {
+        SolverState state = buildSolverState(graph);
+        Rng rng(1);
+        options.maxIterations = iterations;
+        const size_t before = heapAllocations;
+        lahcSearch(graph, state, options, rng);
+        return heapAllocations - before;
+    };
+    const size_t shortRun = allocationsOf(10);
+    const size_t longRun = allocationsOf(2000);
+    REQUIRE(shortRun == longRun);
+}
@@ -0,0 +1,64 @@
+#include "bitset.hpp"
+#include <catch.hpp>
+#include <utility>
+#include <vector>
+using namespace std;
+
+static BitSet withBits(size_t size, const vector<size_t>& bits) {
+    BitSet set(size);
+    for (size_t bit : bits) set.set(bit, true);
+    return set;
+}
+
+TEST_CASE("BitSet: flip, test and count") {
+    BitSet set(130);
+    set.flip(0);
+    set.flip(64);
+    set.flip(129);
+    set.flip(64);
+    REQUIRE(set.test(0));
+    REQUIRE(!set.test(64));
+    REQUIRE(set.test(129));
+    REQUIRE(set.count() == 2);
+    REQUIRE_THROWS_AS(set.at(130), out_of_range);
+    REQUIRE(BitSet(0).count() == 0);
+}
+
+TEST_CASE("BitSet: differences") {
+    BitSet a = withBits(200, {1, 63, 64, 150, 199});
+    BitSet b = withBits(200, {1, 64, 100, 199});
+    REQUIRE(a.distance(b) == 3);
+    vector<size_t> differences;
+    for (size_t i = a.nextDifference(b, 0); i < a.size(); i = a.nextDifference(b, i + 1)) {
+        differences.push_back(i);
+    }
+    REQUIRE(differences == vector<size_t>{63, 100, 150});
+    REQUIRE(a.nextDifference(a, 0) == a.size());
+    REQUIRE_THROWS_AS(a.distance(BitSet(10)), invalid_argument);
+}
+
+TEST_CASE("BitSet: bitwise operations") {
+    BitSet a = withBits(70, {0, 5, 69});
+    BitSet b = withBits(70, {5, 6});
+    REQUIRE((a ^ b) == withBits(70, {0, 6, 69}));
+    REQUIRE((a & b) == withBits(70, {5}));
+    REQUIRE((a | b) == withBits(70, {0, 5, 6, 69}));
+    REQUIRE(!(a == b));
+}
+
+TEST_CASE("BitSet: copies and moves") {
+    BitSet a = withBits(100, {3, 99});
+    BitSet copy(1);
+    copy = a;
+    REQUIRE(copy == a);
+    copy.flip(3);
+    REQUIRE(a.test(3));
+
+    BitSet moved(move(a));
+    REQUIRE(moved.test(99));
+    REQUIRE(a.size() == 0);
+    BitSet target(5);
+    target = move(moved);
+    REQUIRE(target.size() == 100);
+    REQUIRE(target.count() == 2);
+}
@@ -0,0 +1,196 @@
+#include "components.hpp"
+#include "generator.hpp"
+#include <catch.hpp>
+using namespace std;
+
+// Most counts hidden, so the board falls apart into many small components
+static Board sparseBoard(int width, int height, uint64_t seed) {
+    GeneratorOptions options;
+    options.width = width;
+    options.height = height;
+    options.seed = seed;
+    options.mask = 0.85f;
+    return generateBoard(options).board;
+}
+
+// The board turned by 90 degrees and mirrored
+static Board transposed(const Board& board) {
+    Board result;
+    result.width = board.height;
+    result.height = board.width;
+    for (int x = 0; x < board.width; x++) {
+        string row;
+        for (int y = 0; y < board.height; y++) {
+            row += board.field[y][x];
+        }
+        result.field.push_back(row);
+    }
+    return result;
+}
+
+// Least error of the component over all its assignments
+static int bruteForce(SolverState& state, const Component& component) {
+    const int n = component.bits.size();
+    int best = INT32_MAX;
+    for (int mask = 0; mask < (1 << n); mask++) {
+        for (int i = 0; i < n; i++) {
+            if (state.current.test(component.bits[i]) != (bool)((mask >> i) & 1)) applyFlip(state, component.bits[i]);
+        }
+        int error = 0;
+        for (int count : component.counts) {
+            error += countError(state, count);
+        }
+        best = min(best, error);
+    }
+    return best;
+}
+
+TEST_CASE("findComponents: every bit is in one component with all of its counts") {
+    Graph graph = fromBoard(sparseBoard(40, 40, 2));
+    SolverState state = buildSolverState(graph);
+    vector<Component> components = findComponents(state);
+    REQUIRE(components.size() > 10);
+    vector<int> componentOf(state.bombKeys.size(), -1);
+    for (size_t c = 0; c < components.size(); c++) {
+        for (int bit : components[c].bits) {
+            REQUIRE(componentOf[bit] == -1);
+            componentOf[bit] = c;
+        }
+    }
+    REQUIRE(find(componentOf.begin(), componentOf.end(), -1) == componentOf.end());
+    for (size_t c = 0; c < components.size(); c++) {
+        for (int count : components[c].counts) {
+            for (int slot = 0; slot < 8; slot++) {
+                const int bit = state.countNeighborLookup[count * 8 + slot];
+                if (bit != -1) REQUIRE(componentOf[bit] == (int)c);
+            }
+        }
+    }
+}
+
+TEST_CASE("canonicalShape: the same for every symmetry of the board") {
+    const Board board = sparseBoard(30, 20, 3);
+    Graph graph = fromBoard(board);
+    Graph turned = fromBoard(transposed(board));
+    SolverState state = buildSolverState(graph);
+    SolverState turnedState = buildSolverState(turned);
+    vector<string> keys;
+    vector<string> turnedKeys;
+    for (const Component& component : findComponents(state)) {
+        keys.push_back(canonicalShape(graph, state, component).key);
+    }
+    for (const Component& component : findComponents(turnedState)) {
+        const ComponentShape shape = canonicalShape(turned, turnedState, component);
+        REQUIRE(shape.bits.size() == component.bits.size());
+        turnedKeys.push_back(shape.key);
+    }
+    sort(keys.begin(), keys.end());
+    sort(turnedKeys.begin(), turnedKeys.end());
+    REQUIRE(keys == turnedKeys);
+    // A different count value is a different shape
+    Board changed = board;
+    const size_t x = changed.field[0].find_first_of("123");
+    REQUIRE(x != string::npos);
+    changed.field[0][x] = changed.field[0][x] == '1' ? '2' : '1';
+    Graph changedGraph = fromBoard(changed);
+    SolverState changedState = buildSolverState(changedGraph);
+    vector<string> changedKeys;
+    for (const Component& component : findComponents(changedState)) {
+        changedKeys.push_back(canonicalShape(changedGraph, changedState, component).key);
+    }
+    sort(changedKeys.begin(), changedKeys.end());
+    REQUIRE(changedKeys != keys);
+}
+
+TEST_CASE("solveComponents: the small components end up optimal") {
+    Graph graph = fromBoard(sparseBoard(40, 40, 4));
+    SolverState state = buildSolverState(graph);
+    ComponentOptions options;
+    options.maxBombs = 12;
+    vector<int> undecided = solveComponents(graph, state, nullptr, options);
+    SolverState check = state;
+    for (const Component& component : findComponents(state)) {
+        if ((int)component.bits.size() > options.maxBombs) continue;
+        int error = 0;
+        for (int count : component.counts) {
+            error += countError(state, count);
+        }
+        REQUIRE(error == bruteForce(check, component));
+    }
+    for (int bit : undecided) {
+        REQUIRE(bit < (int)state.bombKeys.size());
+    }
+    // The score was kept up to date
+    applySolution(graph, state, state.current);
+    REQUIRE(errorScore(graph) == state.score);
+}
+
+TEST_CASE("lahcFill: the sweeps leave the solved components alone") {
+    GeneratorOptions generator;
+    generator.width = 40;
+    generator.height = 40;
+    generator.seed = 7;
+    generator.mask = 0.85f;
+    // Wrong counts keep the sweeps going and taking worsening moves
+    generator.infeasible = 0.3f;
+    const Board board = generateBoard(generator).board;
+    ComponentCache cache(1 << 20);
+    LahcOptions options;
+    options.sweepThreads = 2;
+    options.componentCache = &cache;
+    Graph graph = fromBoard(board);
+    scaleBudget(options, graph.bombs.size());
+    lahcFill(graph, options);
+    // The same start as lahcFill, up to the search
+    Graph solved = fromBoard(board);
+    Rng rng(options.seed, options.stream);
+    initialFill(solved, options.init, rng);
+    SolverState state = buildSolverState(solved);
+    ComponentCache fresh(1 << 20);
+    vector<int> undecided = solveComponents(solved, state, &fresh);
+    REQUIRE(undecided.size() < state.bombKeys.size());
+    vector<bool> searched(state.bombKeys.size(), false);
+    for (int bit : undecided) {
+        searched[bit] = true;
+    }
+    for (int bit = 0; bit < (int)state.bombKeys.size(); bit++) {
+        if (searched[bit]) continue;
+        REQUIRE(graph.bombs.at(state.bombKeys[bit]).armed == state.current.test(bit));
+    }
+}
+
+TEST_CASE("ComponentCache: a turned board hits every small component") {
+    const Board board = sparseBoard(40, 30, 5);
+    ComponentCache cache(1 << 20);
+    Graph graph = fromBoard(board);
+    SolverState state = buildSolverState(graph);
+    solveComponents(graph, state, &cache);
+    const ComponentCacheStats first = cache.stats();
+    REQUIRE(first.misses > 0);
+    REQUIRE(first.entries > 0);
+    Graph turned = fromBoard(transposed(board));
+    SolverState turnedState = buildSolverState(turned);
+    solveComponents(turned, turnedState, &cache);
+    const ComponentCacheStats second = cache.stats();
+    REQUIRE(second.misses == first.misses);
+    REQUIRE(second.hits > first.hits);
+    // The cached solutions are as good on the turned board, the large components start unarmed on both
+    applySolution(turned, turnedState, turnedState.current);
+    REQUIRE(errorScore(turned) == turnedState.score);
+    REQUIRE(turnedState.score == state.score);
+}
+
+TEST_CASE("ComponentCache: the least recently used shapes get evicted at the cap") {
+    Graph graph = fromBoard(sparseBoard(40, 40, 6));
+    SolverState state = buildSolverState(graph);
+    ComponentCache unlimited(1 << 20);
+    solveComponents(graph, state, &unlimited);
+    const size_t all = unlimited.stats().bytes;
+    ComponentCache capped(all / 2);
+    SolverState again = buildSolverState(graph);
+    solveComponents(graph, again, &capped);
+    const ComponentCacheStats stats = capped.stats();
+    REQUIRE(stats.bytes <= all / 2);
+    REQUIRE(stats.evictions > 0);
+    REQUIRE(stats.entries < unlimited.stats().entries);
+}
@@ -0,0 +1,55 @@
+#include "deltas.hpp"
+#include "generator.hpp"
+#include <catch.hpp>
+using namespace std;
+
+static const DeltaKernel KERNELS[] = {DeltaKernel::Scalar, DeltaKernel::Sse4, DeltaKernel::Avx2};
+
+TEST_CASE("flipDeltas: kernels match lahcFlipScoreImpact") {
+    GeneratorOptions options;
+    options.width = 40;
+    options.height = 30;
+    options.seed = 11;
+    options.mask = 0.3f;
+    Graph graph = fromBoard(generateBoard(options).board);
+    Rng rng(3);
+    for (auto& [key, bomb] : graph.bombs) {
+        bomb.armed = rng.below(2);
+    }
+    SolverState state = buildSolverState(graph);
+    const int bits = state.bombKeys.size();
+    vector<int> expected(bits);
+    for (int i = 0; i < bits; i++) {
+        expected[i] = lahcFlipScoreImpact(state, i);
+    }
+    for (DeltaKernel kernel : KERNELS) {
+        if (!deltaKernelSupported(kernel)) continue;
+        vector<int> deltas(bits);
+        flipDeltas(state, 0, bits, deltas.data(), kernel);
+        REQUIRE(deltas == expected);
+        // Ranges which do not start or end on a vector boundary
+        vector<int> part(bits - 8);
+        flipDeltas(state, 3, bits - 8, part.data(), kernel);
+        REQUIRE(part == vector<int>(expected.begin() + 3, expected.end() - 5));
+    }
+}
+
+TEST_CASE("flipDeltas: 16 bit lookup gives the same deltas") {
+    GeneratorOptions options;
+    options.width = 30;
+    options.height = 20;
+    options.seed = 5;
+    Graph graph = fromBoard(generateBoard(options).board);
+    SolverState state = buildSolverState(graph);
+    REQUIRE(indexWidthFor(state) == IndexWidth::Narrow);
+    const pmr::vector<uint16_t> impacts = narrowImpacts<uint16_t>(state);
+    const int bits = state.bombKeys.size();
+    vector<int> expected(bits);
+    flipDeltas(state, 0, bits, expected.data(), DeltaKernel::Scalar);
+    for (DeltaKernel kernel : KERNELS) {
+        if (!deltaKernelSupported(kernel)) continue;
+        vector<int> deltas(bits);
+        flipDeltas(state, impacts.data(), 0, bits, deltas.data(), kernel);
+        REQUIRE(deltas == expected);
+    }
+}
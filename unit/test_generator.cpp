@@ -0,0 +1,46 @@
+#include "generator.hpp"
+#include "optimization.hpp"
+#include <catch.hpp>
+using namespace std;
+
+// Error of the planted solution on the generated board
+static int plantedScore(const GeneratedBoard& generated) {
+    Graph graph = fromBoard(generated.board);
+    armFromBoard(graph, generated.solution);
+    return errorScore(graph);
+}
+
+TEST_CASE("generateBoard: the planted solution has no error") {
+    GeneratorOptions options;
+    options.width = 40;
+    options.height = 30;
+    options.seed = 3;
+    options.mask = 0.3f;
+    for (bool clustered : {false, true}) {
+        options.clustered = clustered;
+        GeneratedBoard generated = generateBoard(options);
+        REQUIRE(generated.board.field.size() == 30);
+        REQUIRE(generated.board.field[0].size() == 40);
+        REQUIRE(generated.plantedError == 0);
+        REQUIRE(plantedScore(generated) == 0);
+    }
+}
+
+TEST_CASE("generateBoard: the same seed gives the same board") {
+    GeneratorOptions options;
+    options.seed = 9;
+    REQUIRE(generateBoard(options).board.field == generateBoard(options).board.field);
+    GeneratorOptions other = options;
+    other.seed = 10;
+    REQUIRE(generateBoard(options).board.field != generateBoard(other).board.field);
+}
+
+TEST_CASE("generateBoard: infeasible counts are accounted for") {
+    GeneratorOptions options;
+    options.width = 50;
+    options.height = 50;
+    options.infeasible = 0.05f;
+    GeneratedBoard generated = generateBoard(options);
+    REQUIRE(generated.plantedError > 0);
+    REQUIRE(plantedScore(generated) == generated.plantedError);
+}
@@ -0,0 +1,45 @@
+#include "input.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+using namespace std;
+
+static string writeTemp(const string& name, const string& content) {
+    string path = "build/unit/" + name;
+    ofstream out(path, ios::binary);
+    out << content;
+    return path;
+}
+
+TEST_CASE("MappedBoard: rows point into the file") {
+    string path = writeTemp("mapped.txt", "X1.\n\n1..\n...\n---\nLAHC score: 0\n");
+    MappedBoard mapped(path);
+    REQUIRE_FALSE(mapped.board().packed);
+    const BoardView& view = mapped.board().view;
+    REQUIRE(view.width == 3);
+    REQUIRE(view.height == 3);
+    REQUIRE(string(view.rows[1], 3) == "1..");
+    Graph graph = fromBoard(view);
+    REQUIRE(graph.counts.size() == 2);
+    REQUIRE(graph.bombs.at(bombKey(0, 0)).armed);
+    remove(path.c_str());
+}
+
+TEST_CASE("MappedBoard: last row without newline and empty files") {
+    string path = writeTemp("noend.txt", "..\n.1");
+    MappedBoard mapped(path);
+    REQUIRE(mapped.board().height == 2);
+    remove(path.c_str());
+
+    string empty = writeTemp("empty.txt", "");
+    MappedBoard nothing(empty);
+    REQUIRE(nothing.board().height == 0);
+    remove(empty.c_str());
+}
+
+TEST_CASE("MappedBoard: errors") {
+    string path = writeTemp("uneven.txt", "...\n..\n");
+    REQUIRE_THROWS_AS(MappedBoard(path), runtime_error);
+    remove(path.c_str());
+    REQUIRE_THROWS_AS(MappedBoard("build/unit/does_not_exist.txt"), runtime_error);
+}
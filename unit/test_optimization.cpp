@@ -0,0 +1,157 @@
+#include "representation.hpp"
+#include "optimization.hpp"
+#include "lns.hpp"
+#include <catch.hpp>
+using namespace std;
+
+static Graph graphOf(const vector<string>& field) {
+    Board board;
+    board.field = field;
+    board.height = field.size();
+    board.width = field.empty() ? 0 : field[0].size();
+    return fromBoard(board);
+}
+
+TEST_CASE("buildSolverState: score matches errorScore") {
+    Graph graph = graphOf({
+        "X.X",
+        ".3.",
+        "1.."
+    });
+    SolverState state = buildSolverState(graph);
+    REQUIRE(state.bombKeys.size() == 7);
+    REQUIRE(state.score == errorScore(graph));
+    // Flipping keeps the score incremental
+    for (size_t i = 0; i < state.bombKeys.size(); i++) {
+        int expected = state.score + lahcFlipScoreImpact(state, i);
+        applyFlip(state, i);
+        REQUIRE(state.score == expected);
+    }
+    applySolution(graph, state, state.current);
+    REQUIRE(state.score == errorScore(graph));
+    // The masks are the same as if they were built from the new solution
+    REQUIRE(state.countMasks == buildSolverState(graph).countMasks);
+}
+
+TEST_CASE("MASK_ERROR: distance of the armed neighbors to the target") {
+    static_assert(MASK_ERROR[2 << 8 | 0b00000111] == 1, "the table is computed at compile time");
+    REQUIRE(MASK_ERROR[3 << 8 | 0b00000000] == 3);
+    REQUIRE(MASK_ERROR[3 << 8 | 0b10010001] == 0);
+    REQUIRE(MASK_ERROR[0 << 8 | 0b11111111] == 8);
+    REQUIRE(MASK_ERROR[9 << 8 | 0b01000000] == 8);
+}
+
+TEST_CASE("lnsRepairWindow: window over the whole board is solved exactly") {
+    Graph graph = graphOf({
+        "...4..",
+        ".....1",
+        "..2...",
+        "......"
+    });
+    SolverState state = buildSolverState(graph);
+    LahcOptions options;
+    options.lnsWindow = 13;
+    LnsWindow window;
+    Rng rng(1);
+    int before = state.score;
+    int delta = lnsRepairWindow(graph, state, window, 0, options, rng);
+    lnsApplyWindow(state, window);
+    REQUIRE(state.score == before + delta);
+    REQUIRE(state.score == 0);
+    applySolution(graph, state, state.current);
+    REQUIRE(errorScore(graph) == 0);
+}
+
+TEST_CASE("lahcFill: LNS steps solve a small board") {
+    Graph graph = graphOf({
+        "...4..",
+        ".....1",
+        "..2...",
+        "......"
+    });
+    LahcOptions options;
+    options.lnsPeriod = 1;
+    lahcFill(graph, options);
+    REQUIRE(errorScore(graph) == 0);
+}
+
+TEST_CASE("lahcFill: warm start from the input marks") {
+    Graph graph = graphOf({
+        "..X4..",
+        "..XXX1",
+        "..2...",
+        "......"
+    });
+    REQUIRE(errorScore(graph) == 0);
+    LahcOptions options;
+    options.init = InitStrategy::Input;
+    // Already solved, so no iterations are needed
+    REQUIRE(lahcFill(graph, options) == 0);
+    REQUIRE(errorScore(graph) == 0);
+}
+
+TEST_CASE("greedyFill: forced counts are satisfied") {
+    Graph graph = graphOf({
+        "...4..",
+        ".....1",
+        "..2...",
+        "......"
+    });
+    greedyFill(graph);
+    REQUIRE(errorScore(graph) == 0);
+
+    // 8 around the middle forces all of its neighbors
+    Graph full = graphOf({
+        "...",
+        ".8.",
+        "..."
+    });
+    greedyFill(full);
+    for (const auto& [key, bomb] : full.bombs) {
+        REQUIRE(bomb.armed);
+    }
+}
+
+TEST_CASE("lahcFill: the same seed gives the same solution") {
+    vector<string> field = {
+        "..1.....2.",
+        ".....3....",
+        "2..1....1.",
+        "......2...",
+        ".1.....1.."
+    };
+    LahcOptions options;
+    options.maxIterations = 200;
+    options.scoreMemorySize = 20;
+    options.lnsPeriod = 7;
+    options.seed = 12345;
+    Graph first = graphOf(field);
+    Graph second = graphOf(field);
+    REQUIRE(lahcFill(first, options) == lahcFill(second, options));
+    for (const auto& [key, bomb] : first.bombs) {
+        REQUIRE(bomb.armed == second.bombs.at(key).armed);
+    }
+}
+
+TEST_CASE("lahcFill: 16 bit lookups search the same as the int ones") {
+    vector<string> field = {
+        "..1.....2.",
+        ".....3....",
+        "2..1....1.",
+        "......2...",
+        ".1.....1.."
+    };
+    LahcOptions options;
+    options.maxIterations = 200;
+    options.scoreMemorySize = 20;
+    options.lnsPeriod = 7;
+    options.seed = 99;
+    Graph narrow = graphOf(field);
+    Graph wide = graphOf(field);
+    int narrowIterations = lahcFill(narrow, options);
+    options.narrowIndices = false;
+    REQUIRE(narrowIterations == lahcFill(wide, options));
+    for (const auto& [key, bomb] : narrow.bombs) {
+        REQUIRE(bomb.armed == wide.bombs.at(key).armed);
+    }
+}
@@ -0,0 +1,32 @@
+#include "output.hpp"
+#include <catch.hpp>
+#include <sstream>
+using namespace std;
+
+// Counts with mines around them, the bombs are armed as the X marks say
+static Graph solved() {
+    Board board = {{"XX.X", "2221", "X..."}, 4, 3};
+    return fromBoard(board);
+}
+
+TEST_CASE("writeMines: row-major coordinates") {
+    ostringstream out;
+    writeMines(solved(), out);
+    REQUIRE(out.str() == "0 0\n1 0\n3 0\n0 2\n");
+}
+
+TEST_CASE("writeRle: runs per row") {
+    ostringstream out;
+    writeRle(solved(), out);
+    REQUIRE(out.str() == "0 2 1 1\n\n0 1\n");
+}
+
+TEST_CASE("writeDiff: added and removed mines") {
+    Graph graph = solved();
+    vector<pair<int, int>> marks = armedCells(graph);
+    graph.bombs.at(bombKey(1, 0)).armed = false;
+    graph.bombs.at(bombKey(2, 2)).armed = true;
+    ostringstream out;
+    writeDiff(graph, marks, out);
+    REQUIRE(out.str() == "- 1 0\n+ 2 2\n");
+}
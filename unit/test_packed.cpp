@@ -0,0 +1,102 @@
+#include "packed.hpp"
+#include "input.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+using namespace std;
+
+static CellPlane planeOfText(const string& text) {
+    return planeOf(scanBoard(text.data(), text.size(), true));
+}
+
+TEST_CASE("packPlane: round trip") {
+    // Odd width, so the last byte of a row has a padding nibble, and long runs for the compression
+    const string text = "X1.......................................................\n"
+                        "9........................................................\n"
+                        "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX2\n";
+    CellPlane plane = planeOfText(text);
+    for (bool compress : {false, true}) {
+        string packed = packPlane(plane, compress);
+        REQUIRE(isPacked(packed.data(), packed.size()));
+        CellPlane unpacked = unpackPlane(packed.data(), packed.size());
+        REQUIRE(unpacked.width == 57);
+        REQUIRE(unpacked.height == 3);
+        REQUIRE(unpacked.cells == plane.cells);
+        REQUIRE(planeText(unpacked) == text);
+    }
+    REQUIRE(packPlane(plane, true).size() < packPlane(plane, false).size());
+    REQUIRE(packPlane(plane, false).size() == PACKED_HEADER_SIZE + 3 * 29);
+}
+
+TEST_CASE("unpackPlane: damaged data") {
+    CellPlane plane = planeOfText("X1.\n...\n");
+    for (bool compress : {false, true}) {
+        string packed = packPlane(plane, compress);
+        string flipped = packed;
+        flipped[PACKED_HEADER_SIZE + (compress ? 5 : 0)] ^= 1;
+        REQUIRE_THROWS_AS(unpackPlane(flipped.data(), flipped.size()), runtime_error);
+        string truncated = packed.substr(0, packed.size() - 1);
+        REQUIRE_THROWS_AS(unpackPlane(truncated.data(), truncated.size()), runtime_error);
+    }
+    string forged = packPlane(plane, false);
+    forged[15] = 0x7f; // a huge height without the rows
+    REQUIRE_THROWS_AS(unpackPlane(forged.data(), forged.size()), runtime_error);
+    // Rows without cells would take no bytes at all
+    string empty = packPlane(CellPlane(), false);
+    empty[15] = 0x7f;
+    REQUIRE_THROWS_AS(unpackPlane(empty.data(), empty.size()), runtime_error);
+    empty = packPlane(CellPlane(), true);
+    REQUIRE(unpackPlane(empty.data(), empty.size()).height == 0);
+    REQUIRE(!isPacked("X1.\n", 4));
+}
+
+TEST_CASE("planeOf: solved graph") {
+    Board board = {{"X1", ".."}, 2, 2};
+    Graph graph = fromBoard(board);
+    graph.bombs.at(bombKey(0, 1)).armed = true;
+    graph.bombs.at(bombKey(0, 0)).armed = false;
+    REQUIRE(planeText(planeOf(graph)) == ".1\nX.\n");
+}
+
+TEST_CASE("fromPlane: the same graph as fromBoard on the text") {
+    const string text = "X1.2.\n"
+                        ".39X0\n"
+                        "X..1.\n";
+    Graph expected = fromBoard(scanBoard(text.data(), text.size()).view);
+    Graph graph = fromPlane(planeOfText(text));
+    REQUIRE(graph.width == expected.width);
+    REQUIRE(graph.height == expected.height);
+    REQUIRE(graph.bombs.size() == expected.bombs.size());
+    for (const auto& [key, bomb] : expected.bombs) {
+        REQUIRE(graph.bombs.at(key).armed == bomb.armed);
+    }
+    REQUIRE(graph.counts.size() == expected.counts.size());
+    for (size_t i = 0; i < graph.counts.size(); i++) {
+        const Count& count = graph.counts[i];
+        REQUIRE(count.x == expected.counts[i].x);
+        REQUIRE(count.y == expected.counts[i].y);
+        REQUIRE(count.count == expected.counts[i].count);
+        for (int slot = 0; slot < 8; slot++) {
+            const Bomb* bomb = expected.counts[i].neighbors[slot];
+            REQUIRE((count.neighbors[slot] == nullptr) == (bomb == nullptr));
+            if (bomb != nullptr) REQUIRE(count.neighbors[slot] == &graph.bombs.at(bombKey(bomb->x, bomb->y)));
+        }
+    }
+}
+
+TEST_CASE("MappedBoard: packed files") {
+    CellPlane plane = planeOfText("X1.\n...\n");
+    string path = "build/unit/packed.swb";
+    {
+        ofstream out(path, ios::binary);
+        out << packPlane(plane, true);
+    }
+    MappedBoard mapped(path);
+    REQUIRE(mapped.board().packed);
+    REQUIRE(mapped.board().width == 3);
+    REQUIRE(mapped.board().height == 2);
+    REQUIRE(planeOf(mapped.board()).cells == plane.cells);
+    string text;
+    REQUIRE(string(rowsOf(mapped.board(), text).rows[0], 3) == "X1.");
+    remove(path.c_str());
+}
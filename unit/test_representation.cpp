@@ -135,3 +135,57 @@ TEST_CASE("fromBoard: empty board") {
     REQUIRE(graph.bombs.empty());
     REQUIRE(graph.counts.empty());
 }
+
+TEST_CASE("readBoard: stops at the separator") {
+    istringstream in("X1\n\n1.\n---\nLAHC score: 0\n");
+    Board board = readBoard(in);
+    REQUIRE(board.width == 2);
+    REQUIRE(board.height == 2);
+    REQUIRE(board.field[1] == "1.");
+}
+
+TEST_CASE("readBoard: inconsistent width") {
+    istringstream in("...\n..\n");
+    REQUIRE_THROWS_AS(readBoard(in), runtime_error);
+}
+
+TEST_CASE("armFromBoard: copies the marks") {
+    Board board;
+    board.width = 2;
+    board.height = 2;
+    board.field = {
+        "X1",
+        "1."
+    };
+    Graph graph = fromBoard(board);
+    Board marks = board;
+    marks.field = {
+        ".1",
+        "1X"
+    };
+    armFromBoard(graph, marks);
+    REQUIRE(!graph.bombs.at(bombKey(0, 0)).armed);
+    REQUIRE(graph.bombs.at(bombKey(1, 1)).armed);
+    marks.width = 3;
+    REQUIRE_THROWS_AS(armFromBoard(graph, marks), invalid_argument);
+}
+
+TEST_CASE("streamGraph: same as the rendered buffer") {
+    Board board;
+    board.width = 5;
+    board.height = 4;
+    board.field = {
+        "X1.2X",
+        "1..X.",
+        "..3..",
+        "X...1"
+    };
+    Graph graph = fromBoard(board);
+    string rendered = renderGraph(graph);
+    REQUIRE(rendered == "X1.2X\n1..X.\n..3..\nX...1\n");
+    for (int band : {1, 3, 4, 10}) {
+        ostringstream out;
+        streamGraph(graph, out, band);
+        REQUIRE(out.str() == rendered);
+    }
+}
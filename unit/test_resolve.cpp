@@ -0,0 +1,85 @@
+#include "representation.hpp"
+#include "optimization.hpp"
+#include "resolve.hpp"
+#include <catch.hpp>
+using namespace std;
+
+static Board boardOf(const vector<string>& field) {
+    Board board;
+    board.field = field;
+    board.height = field.size();
+    board.width = field.empty() ? 0 : field[0].size();
+    return board;
+}
+
+// The session has to look exactly like a fresh build of the edited board
+static void requireConsistent(const Session& session) {
+    Graph fresh = fromBoard(session.board);
+    REQUIRE(fresh.counts.size() == session.graph.counts.size());
+    REQUIRE(fresh.bombs.size() == session.graph.bombs.size());
+    for (auto& [key, bomb] : fresh.bombs) {
+        auto it = session.graph.bombs.find(key);
+        REQUIRE(it != session.graph.bombs.end());
+        bomb.armed = it->second.armed;
+    }
+    REQUIRE(errorScore(fresh) == session.state.score);
+    REQUIRE(errorScore(session.graph) == session.state.score);
+    REQUIRE(buildSolverState(session.graph).score == session.state.score);
+}
+
+TEST_CASE("resolve: edits keep the session consistent") {
+    LahcOptions options;
+    Session session = startSession(boardOf({
+        "...4..",
+        ".....1",
+        "..2...",
+        "......"
+    }), options);
+    REQUIRE(session.state.score == 0);
+
+    applyEdit(session, {4, 3, EditKind::SetCount, 1});
+    requireConsistent(session);
+    REQUIRE(resolve(session, options) == 0);
+    requireConsistent(session);
+
+    // Change an existing count
+    applyEdit(session, {2, 2, EditKind::SetCount, 3});
+    requireConsistent(session);
+    REQUIRE(resolve(session, options) == 0);
+
+    // Remove a count
+    applyEdit(session, {3, 0, EditKind::Clear});
+    requireConsistent(session);
+    REQUIRE(resolve(session, options) == 0);
+    requireConsistent(session);
+
+    // Mark a mine, then remove the mark
+    applyEdit(session, {0, 3, EditKind::ToggleMine});
+    requireConsistent(session);
+    applyEdit(session, {0, 3, EditKind::ToggleMine});
+    requireConsistent(session);
+    REQUIRE(resolve(session, options) == 0);
+    requireConsistent(session);
+}
+
+TEST_CASE("resolve: count replacing a bomb") {
+    LahcOptions options;
+    Session session = startSession(boardOf({
+        "X1.",
+        "...",
+        "..."
+    }), options);
+    applyEdit(session, {0, 0, EditKind::SetCount, 0});
+    requireConsistent(session);
+    applyEdit(session, {1, 0, EditKind::ToggleMine});
+    requireConsistent(session);
+    REQUIRE(resolve(session, options) == 0);
+    requireConsistent(session);
+}
+
+TEST_CASE("applyEdit: rejects invalid edits") {
+    LahcOptions options;
+    Session session = startSession(boardOf({"1."}), options);
+    REQUIRE_THROWS_AS(applyEdit(session, {2, 0, EditKind::Clear}), out_of_range);
+    REQUIRE_THROWS_AS(applyEdit(session, {1, 0, EditKind::SetCount, 10}), invalid_argument);
+}
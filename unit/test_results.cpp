@@ -0,0 +1,219 @@
+#include "results.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+static CachedResult resultWith(int score, int mines) {
+    CachedResult result;
+    result.score = score;
+    result.iterations = score * 10;
+    result.seed = score + 1;
+    result.seconds = 0.5;
+    for (int i = 0; i < mines; i++) {
+        result.mines.push_back({i, score});
+    }
+    return result;
+}
+
+static ResultKey keyOf(const string& board) {
+    return resultKey(board.data(), board.size(), 100, 100, 7);
+}
+
+static void removeCache(const string& path) {
+    remove(path.c_str());
+    remove((path + ".lock").c_str());
+}
+
+TEST_CASE("contentHash: every byte, the length and the seed count") {
+    string data(100, '.');
+    for (size_t size : {0, 1, 7, 8, 31, 32, 33, 64, 100}) {
+        const uint64_t hash = contentHash(data.data(), size);
+        REQUIRE(hash == contentHash(data.data(), size));
+        REQUIRE(hash != contentHash(data.data(), size, 1));
+        if (size < 100) REQUIRE(hash != contentHash(data.data(), size + 1));
+        for (size_t i = 0; i < size; i++) {
+            string changed = data;
+            changed[i] = '1';
+            REQUIRE(contentHash(changed.data(), size) != hash);
+        }
+    }
+}
+
+TEST_CASE("ResultCache: finds what was inserted and evicts the least recently used") {
+    ResultCache probe(1 << 20);
+    probe.insert(keyOf("a"), resultWith(1, 10));
+    const size_t entry = probe.stats().bytes;
+    // Room for two entries
+    ResultCache cache(2 * entry + entry / 2);
+    REQUIRE(cache.find(keyOf("a")) == nullptr);
+    cache.insert(keyOf("a"), resultWith(1, 10));
+    cache.insert(keyOf("b"), resultWith(2, 10));
+    const CachedResult* found = cache.find(keyOf("a"));
+    REQUIRE(found != nullptr);
+    REQUIRE(found->score == 1);
+    REQUIRE(found->mines == resultWith(1, 10).mines);
+    // b is the least recently used now
+    cache.insert(keyOf("c"), resultWith(3, 10));
+    REQUIRE(cache.find(keyOf("b")) == nullptr);
+    REQUIRE(cache.find(keyOf("a")) != nullptr);
+    REQUIRE(cache.find(keyOf("c")) != nullptr);
+    // The same hash with another size or other dimensions is another board
+    REQUIRE(cache.find({keyOf("c").hash, 2, 100, 100}) == nullptr);
+    REQUIRE(cache.find({keyOf("c").hash, 1, 100, 99}) == nullptr);
+    const ResultCacheStats stats = cache.stats();
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.evictions == 1);
+    REQUIRE(stats.hits == 3);
+    REQUIRE(stats.misses == 4);
+    REQUIRE(stats.bytes <= 2 * entry + entry / 2);
+}
+
+TEST_CASE("ResultCache: the file survives a restart and a torn last result") {
+    const string path = "build/unit/results.cache";
+    removeCache(path);
+    {
+        ResultCache cache(1 << 20, path);
+        cache.insert(keyOf("a"), resultWith(1, 3));
+        cache.insert(keyOf("b"), resultWith(2, 5));
+    }
+    {
+        ResultCache cache(1 << 20, path);
+        REQUIRE(cache.stats().entries == 2);
+        const CachedResult* found = cache.find(keyOf("b"));
+        REQUIRE(found != nullptr);
+        REQUIRE(found->iterations == 20);
+        REQUIRE(found->seed == 3);
+        REQUIRE(found->seconds == 0.5);
+        REQUIRE(found->mines == resultWith(2, 5).mines);
+        cache.insert(keyOf("c"), resultWith(3, 4));
+    }
+    // A crash in the middle of writing c
+    filesystem::resize_file(path, filesystem::file_size(path) - 5);
+    {
+        ResultCache cache(1 << 20, path);
+        REQUIRE(cache.stats().entries == 2);
+        REQUIRE(cache.find(keyOf("a")) != nullptr);
+        REQUIRE(cache.find(keyOf("c")) == nullptr);
+        cache.insert(keyOf("c"), resultWith(3, 4));
+    }
+    {
+        ResultCache cache(1 << 20, path);
+        REQUIRE(cache.stats().entries == 3);
+        REQUIRE(cache.find(keyOf("c"))->score == 3);
+    }
+    removeCache(path);
+}
+
+TEST_CASE("ResultCache: the file stays small when results get replaced") {
+    const string path = "build/unit/replaced.cache";
+    removeCache(path);
+    {
+        ResultCache cache(1 << 20, path);
+        for (int i = 0; i < 100; i++) {
+            cache.insert(keyOf("a"), resultWith(i, 10));
+        }
+        REQUIRE(cache.stats().entries == 1);
+    }
+    REQUIRE(filesystem::file_size(path) < 10 * (8 + 60 + 10 * 8));
+    ResultCache cache(1 << 20, path);
+    REQUIRE(cache.find(keyOf("a"))->score == 99);
+    removeCache(path);
+}
+
+TEST_CASE("ResultCache: other files are refused") {
+    const string path = "build/unit/board.txt";
+    {
+        ofstream out(path);
+        out << "1X.\n";
+    }
+    REQUIRE_THROWS_AS(ResultCache(1 << 20, path), runtime_error);
+    removeCache(path);
+}
+
+TEST_CASE("resultFits: mines outside of the board or on counts do not fit") {
+    CellPlane board;
+    board.width = 3;
+    board.height = 2;
+    board.cells = {CELL_UNKNOWN, 1, CELL_MINE, CELL_UNKNOWN, CELL_UNKNOWN, 0};
+    CachedResult result;
+    result.mines = {{0, 0}, {2, 0}, {1, 1}};
+    REQUIRE(resultFits(result, board));
+    for (pair<int, int> mine : {pair{1, 0}, pair{2, 1}, pair{3, 0}, pair{0, 2}, pair{-1, 0}}) {
+        CachedResult wrong = result;
+        wrong.mines.push_back(mine);
+        REQUIRE_FALSE(resultFits(wrong, board));
+    }
+}
+
+TEST_CASE("ResultCache: a dropped result is a miss") {
+    ResultCache cache(1 << 20);
+    cache.insert(keyOf("a"), resultWith(1, 3));
+    REQUIRE(cache.find(keyOf("a")) != nullptr);
+    cache.drop(keyOf("a"));
+    REQUIRE(cache.find(keyOf("a")) == nullptr);
+    REQUIRE(cache.stats().hits == 0);
+    REQUIRE(cache.stats().misses == 2);
+    REQUIRE(cache.stats().entries == 0);
+}
+
+TEST_CASE("ResultCache: only one cache at a time writes the file") {
+    const string path = "build/unit/shared.cache";
+    removeCache(path);
+    {
+        ResultCache writer(1 << 20, path);
+        REQUIRE_FALSE(writer.readOnly());
+        writer.insert(keyOf("a"), resultWith(1, 3));
+        ResultCache reader(1 << 20, path);
+        REQUIRE(reader.readOnly());
+        REQUIRE(reader.find(keyOf("a")) != nullptr);
+        // The results of the reader stay in its memory
+        reader.insert(keyOf("b"), resultWith(2, 3));
+        REQUIRE(reader.find(keyOf("b")) != nullptr);
+        // Compactions of the writer do not lose anything
+        for (int i = 0; i < 50; i++) {
+            writer.insert(keyOf("c"), resultWith(i, 3));
+        }
+    }
+    ResultCache next(1 << 20, path);
+    REQUIRE_FALSE(next.readOnly());
+    REQUIRE(next.find(keyOf("a")) != nullptr);
+    REQUIRE(next.find(keyOf("b")) == nullptr);
+    REQUIRE(next.find(keyOf("c"))->score == 49);
+    // Once a writer stops, the file is free for another one
+    next.stopWriting();
+    ResultCache after(1 << 20, path);
+    REQUIRE_FALSE(after.readOnly());
+    removeCache(path);
+}
+
+#ifndef _WIN32
+TEST_CASE("ResultCache: a failed append throws and keeps the result in memory") {
+    const string path = "build/unit/full.cache";
+    removeCache(path);
+    ResultCache cache(1 << 20, path);
+    cache.insert(keyOf("a"), resultWith(1, 3));
+    // The file can not grow anymore, like on a full disk
+    signal(SIGXFSZ, SIG_IGN);
+    rlimit old;
+    getrlimit(RLIMIT_FSIZE, &old);
+    rlimit full = old;
+    full.rlim_cur = filesystem::file_size(path);
+    setrlimit(RLIMIT_FSIZE, &full);
+    REQUIRE_THROWS_AS(cache.insert(keyOf("b"), resultWith(2, 3)), runtime_error);
+    // What solveAndWrite does after the throw, while the disk is still full
+    cache.stopWriting();
+    setrlimit(RLIMIT_FSIZE, &old);
+    signal(SIGXFSZ, SIG_DFL);
+    REQUIRE(cache.find(keyOf("b")) != nullptr);
+    ResultCache reopened(1 << 20, path);
+    REQUIRE(reopened.find(keyOf("a")) != nullptr);
+    REQUIRE(reopened.find(keyOf("b")) == nullptr);
+    removeCache(path);
+}
+#endif
@@ -0,0 +1,33 @@
+#include "rng.hpp"
+#include <catch.hpp>
+#include <vector>
+using namespace std;
+
+TEST_CASE("Rng: same seed and stream give the same sequence") {
+    Rng a(42);
+    Rng b(42);
+    Rng other(42, 1);
+    bool differs = false;
+    for (int i = 0; i < 100; i++) {
+        uint64_t value = a.next();
+        REQUIRE(value == b.next());
+        differs = differs || value != other.next();
+    }
+    REQUIRE(differs);
+}
+
+TEST_CASE("Rng: bounded draws stay in range and cover it") {
+    Rng rng(7);
+    vector<int> seen(10, 0);
+    for (int i = 0; i < 10000; i++) {
+        uint32_t value = rng.below(10);
+        REQUIRE(value < 10);
+        seen[value]++;
+        float f = rng.unit();
+        REQUIRE(f >= 0.0f);
+        REQUIRE(f < 1.0f);
+    }
+    for (int count : seen) {
+        REQUIRE(count > 800);
+    }
+}
@@ -0,0 +1,66 @@
+#include "scan.hpp"
+#include <catch.hpp>
+using namespace std;
+
+static const ScanKernel KERNELS[] = {ScanKernel::Scalar, ScanKernel::Sse2, ScanKernel::Avx2};
+
+static ScannedBoard scan(const string& text, ScanKernel kernel) {
+    return scanBoard(text.data(), text.size(), true, kernel);
+}
+
+static string errorOf(const string& text, ScanKernel kernel) {
+    try {
+        scan(text, kernel);
+    } catch (const runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+TEST_CASE("scanBoard: rows and classes") {
+    for (ScanKernel kernel : KERNELS) {
+        if (!scanKernelSupported(kernel)) continue;
+        // The rows point into the text, so it has to outlive the board
+        const string text = "X1.\n\n9..\r\n...\n---\nLAHC score: 0\n";
+        ScannedBoard board = scan(text, kernel);
+        REQUIRE(board.view.width == 3);
+        REQUIRE(board.view.height == 3);
+        REQUIRE(string(board.view.rows[1], 3) == "9..");
+        REQUIRE(board.cells == vector<uint8_t>{
+            CELL_MINE, 1, CELL_UNKNOWN,
+            9, CELL_UNKNOWN, CELL_UNKNOWN,
+            CELL_UNKNOWN, CELL_UNKNOWN, CELL_UNKNOWN});
+        REQUIRE(scan("", kernel).view.height == 0);
+        REQUIRE(scan("..\n.1", kernel).view.height == 2);
+    }
+}
+
+TEST_CASE("scanBoard: kernels agree on long rows") {
+    // Rows longer than a vector block with malformed bytes at every offset of a block
+    string row;
+    for (int x = 0; x < 77; x++) row += "0123456789X."[(x * 7) % 12];
+    string text;
+    for (int y = 0; y < 5; y++) text += row + "\n";
+    ScannedBoard expected = scan(text, ScanKernel::Scalar);
+    REQUIRE(expected.cells.size() == 77 * 5);
+    for (ScanKernel kernel : KERNELS) {
+        if (!scanKernelSupported(kernel)) continue;
+        REQUIRE(scan(text, kernel).cells == expected.cells);
+        for (int column = 0; column < 77; column++) {
+            string broken = text;
+            broken[2 * 78 + column] = '?';
+            REQUIRE(errorOf(broken, kernel)
+                == "Unexpected character '?' at line 3, column " + to_string(column + 1));
+        }
+    }
+}
+
+TEST_CASE("scanBoard: errors name the position") {
+    for (ScanKernel kernel : KERNELS) {
+        if (!scanKernelSupported(kernel)) continue;
+        REQUIRE(errorOf("...\n\n..\n", kernel) == "Inconsistent row width! Line 3 has 2 cells instead of 3");
+        REQUIRE(errorOf("...\n.\x01.\n", kernel) == "Unexpected character byte 0x01 at line 2, column 2");
+        REQUIRE(errorOf("..\r.\n", kernel) == "Unexpected character byte 0x0d at line 1, column 3");
+        REQUIRE(errorOf("--\n", kernel) == "Unexpected character '-' at line 1, column 1");
+    }
+}
@@ -0,0 +1,101 @@
+#include "stream.hpp"
+#include "generator.hpp"
+#include <sstream>
+#include <catch.hpp>
+using namespace std;
+
+static string boardText(const Board& board) {
+    string text;
+    for (const string& row : board.field) {
+        text += row + "\n";
+    }
+    return text;
+}
+
+// The rows the stream emits, in order
+static vector<string> streamRows(const string& text, const LahcOptions& options, const StreamOptions& stream, StreamResult& result) {
+    istringstream in(text);
+    vector<string> rows;
+    result = streamFill(in, options, stream, [&](int y, const string& row, const string& input) {
+        REQUIRE(y == (int)rows.size());
+        REQUIRE(input.size() == row.size());
+        rows.push_back(row);
+    });
+    return rows;
+}
+
+TEST_CASE("streamFill: every row comes out once with the score of the whole board") {
+    GeneratorOptions generator;
+    generator.width = 30;
+    generator.height = 75;
+    generator.seed = 4;
+    generator.mask = 0.3f;
+    const Board board = generateBoard(generator).board;
+    LahcOptions options;
+    options.seed = 3;
+    StreamOptions stream;
+    stream.band = 12;
+    stream.carry = 4;
+    StreamResult result;
+    Board solved = board;
+    solved.field = streamRows(boardText(board), options, stream, result);
+    REQUIRE(result.rows == 75);
+    REQUIRE(result.width == 30);
+    REQUIRE(result.bands == 9);
+    REQUIRE(solved.field.size() == board.field.size());
+    // The counts stay, everything else is a mine or not
+    for (int y = 0; y < board.height; y++) {
+        for (int x = 0; x < board.width; x++) {
+            const char cell = board.field[y][x];
+            if (cell >= '0' && cell <= '9') {
+                REQUIRE(solved.field[y][x] == cell);
+            } else {
+                REQUIRE((solved.field[y][x] == 'X' || solved.field[y][x] == '.'));
+            }
+        }
+    }
+    Graph graph = fromBoard(board);
+    const int start = errorScore(graph);
+    armFromBoard(graph, solved);
+    REQUIRE(errorScore(graph) == result.score);
+    REQUIRE(result.score < start);
+}
+
+TEST_CASE("streamFill: the same seed gives the same rows") {
+    GeneratorOptions generator;
+    generator.width = 20;
+    generator.height = 40;
+    generator.seed = 9;
+    const string text = boardText(generateBoard(generator).board);
+    LahcOptions options;
+    options.seed = 5;
+    options.init = InitStrategy::Greedy;
+    StreamOptions stream;
+    stream.band = 8;
+    stream.carry = 2;
+    StreamResult first;
+    StreamResult second;
+    REQUIRE(streamRows(text, options, stream, first) == streamRows(text, options, stream, second));
+    REQUIRE(first.score == second.score);
+}
+
+TEST_CASE("streamFill: reads like readBoard") {
+    LahcOptions options;
+    StreamOptions stream;
+    stream.band = 2;
+    stream.carry = 1;
+    StreamResult result;
+    // Empty lines are skipped, \r is dropped and --- ends the board
+    vector<string> rows = streamRows("1.\r\n\n.X\n---\n22\n", options, stream, result);
+    REQUIRE(rows.size() == 2);
+    REQUIRE(rows[0][0] == '1');
+    REQUIRE(result.rows == 2);
+    REQUIRE(result.score == 0);
+    istringstream malformed("1.\n.a\n");
+    REQUIRE_THROWS_AS(streamFill(malformed, options, stream, [](int, const string&, const string&) {}), runtime_error);
+    istringstream uneven("1.\n...\n");
+    REQUIRE_THROWS_AS(streamFill(uneven, options, stream, [](int, const string&, const string&) {}), runtime_error);
+    stream.carry = 2;
+    istringstream board("1.\n");
+    REQUIRE_THROWS_AS(streamFill(board, options, stream, [](int, const string&, const string&) {}), invalid_argument);
+}
@@ -0,0 +1,143 @@
+#include "sweep.hpp"
+#include "arena.hpp"
+#include "generator.hpp"
+#include <catch.hpp>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+static Graph generatedGraph(int width, int height, uint64_t seed) {
+    GeneratorOptions options;
+    options.width = width;
+    options.height = height;
+    options.seed = seed;
+    options.mask = 0.3f;
+    return fromBoard(generateBoard(options).board);
+}
+
+TEST_CASE("colorBits: bombs of a color share no count") {
+    Graph graph = generatedGraph(40, 30, 6);
+    SolverState state = buildSolverState(graph);
+    Coloring coloring = colorBits(state);
+    const int bits = state.bombKeys.size();
+    REQUIRE(coloring.colors >= 1);
+    REQUIRE(coloring.colors <= 25);
+    for (size_t count = 0; count < state.targets.size(); count++) {
+        for (int i = 0; i < 8; i++) {
+            for (int j = i + 1; j < 8; j++) {
+                const int a = state.countNeighborLookup[count * 8 + i];
+                const int b = state.countNeighborLookup[count * 8 + j];
+                if (a != -1 && b != -1) REQUIRE(coloring.color[a] != coloring.color[b]);
+            }
+        }
+    }
+    // Every bit is in the class of its color exactly once
+    REQUIRE((int)coloring.classBits.size() == bits);
+    REQUIRE(coloring.classStart[coloring.colors] == bits);
+    vector<int> seen(bits, 0);
+    for (int c = 0; c < coloring.colors; c++) {
+        for (int i = coloring.classStart[c]; i < coloring.classStart[c + 1]; i++) {
+            REQUIRE(coloring.color[coloring.classBits[i]] == c);
+            seen[coloring.classBits[i]]++;
+        }
+    }
+    REQUIRE(seen == vector<int>(bits, 1));
+}
+
+TEST_CASE("colorBits: only the given bits get colored") {
+    Graph graph = generatedGraph(40, 30, 6);
+    SolverState state = buildSolverState(graph);
+    vector<int> bits;
+    for (int bit = 0; bit < (int)state.bombKeys.size(); bit += 3) {
+        bits.push_back(bit);
+    }
+    Coloring coloring = colorBits(state, &bits);
+    vector<int> classBits(coloring.classBits.begin(), coloring.classBits.end());
+    sort(classBits.begin(), classBits.end());
+    REQUIRE(classBits == bits);
+    for (int bit = 0; bit < (int)state.bombKeys.size(); bit++) {
+        REQUIRE((coloring.color[bit] == -1) == (bit % 3 != 0));
+    }
+}
+
+TEST_CASE("sweepSearch: the state stays consistent with several threads") {
+    Graph graph = generatedGraph(60, 40, 2);
+    for (auto& [key, bomb] : graph.bombs) {
+        bomb.armed = false;
+    }
+    SolverState state = buildSolverState(graph);
+    const int start = state.score;
+    Coloring coloring = colorBits(state);
+    LahcOptions options;
+    options.sweepThreads = 4;
+    scaleBudget(options, state.bombKeys.size());
+    Rng rng(1);
+    sweepSearch(graph, state, coloring, options, rng);
+    REQUIRE(state.score < start);
+    applySolution(graph, state, state.current);
+    REQUIRE(errorScore(graph) == state.score);
+    SolverState rebuilt = buildSolverState(graph);
+    REQUIRE(rebuilt.countMasks == state.countMasks);
+}
+
+TEST_CASE("lahcFill: sweeps give the same result for the same seed and threads") {
+    LahcOptions options;
+    options.sweepThreads = 3;
+    options.seed = 21;
+    Graph first = generatedGraph(30, 20, 4);
+    Graph second = generatedGraph(30, 20, 4);
+    scaleBudget(options, first.bombs.size());
+    REQUIRE(lahcFill(first, options) == lahcFill(second, options));
+    for (const auto& [key, bomb] : first.bombs) {
+        REQUIRE(bomb.armed == second.bombs.at(key).armed);
+    }
+}
+
+// An arena which counts the allocations of other threads than the one which created it
+// The arena is not thread-safe, so the allocations are serialized here to keep the test itself defined
+class OwnedArena : public pmr::memory_resource {
+public:
+    Arena arena;
+    const thread::id owner = this_thread::get_id();
+    int foreign = 0;
+
+private:
+    mutex mutex_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        lock_guard<mutex> lock(mutex_);
+        if (this_thread::get_id() != owner) foreign++;
+        return arena.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        lock_guard<mutex> lock(mutex_);
+        arena.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("lahcFill: the sweep threads take no memory from the arena of the graph") {
+    GeneratorOptions generator;
+    generator.width = 60;
+    generator.height = 40;
+    generator.seed = 3;
+    generator.mask = 0.3f;
+    const Board board = generateBoard(generator).board;
+    OwnedArena memory;
+    Graph graph = fromBoard(board, &memory);
+    LahcOptions options;
+    options.sweepThreads = 4;
+    options.seed = 5;
+    scaleBudget(options, graph.bombs.size());
+    lahcFill(graph, options);
+    REQUIRE(memory.foreign == 0);
+    // The same result as on the heap
+    Graph heap = fromBoard(board);
+    lahcFill(heap, options);
+    REQUIRE(errorScore(graph) == errorScore(heap));
+}
@@ -0,0 +1,100 @@
+#include "telemetry.hpp"
+#include "generator.hpp"
+#include "optimization.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+using namespace std;
+
+// Value of a number field of a JSON line
+static double field(const string& line, const string& name) {
+    const size_t at = line.find("\"" + name + "\":");
+    REQUIRE(at != string::npos);
+    return stod(line.substr(at + name.size() + 3));
+}
+
+TEST_CASE("telemetryConfigure: a file which cannot be opened is an error") {
+    REQUIRE_FALSE(telemetryConfigure("build/unit/missing/telemetry.jsonl", 100));
+    REQUIRE(telemetryConfigure("", 100));
+}
+
+TEST_CASE("telemetry: the snapshots count every iteration of the search") {
+    if (!telemetryCompiled()) return;
+    const string path = "build/unit/telemetry.jsonl";
+    remove(path.c_str());
+    GeneratorOptions generator;
+    generator.width = 20;
+    generator.height = 20;
+    generator.seed = 1;
+    // Wrong counts, so the search does not stop early at a perfect score
+    generator.infeasible = 0.2f;
+    Graph graph = fromBoard(generateBoard(generator).board);
+    LahcOptions options;
+    options.maxIterations = 2000;
+    options.scoreMemorySize = 100;
+    const TelemetryCounters before = telemetryTotal();
+    REQUIRE(telemetryConfigure(path, 500));
+    const int iterations = lahcFill(graph, options);
+    REQUIRE(iterations == options.maxIterations);
+    REQUIRE(telemetryConfigure("", 0));
+    const TelemetryCounters after = telemetryTotal();
+    REQUIRE(after.iterations - before.iterations == (uint64_t)iterations);
+    REQUIRE(after.accepted + after.rejected - before.accepted - before.rejected == (uint64_t)iterations);
+    REQUIRE(after.neutral - before.neutral <= after.accepted - before.accepted);
+    REQUIRE(after.bestScore == errorScore(graph));
+
+    ifstream in(path);
+    vector<string> lines;
+    for (string line; getline(in, line);) {
+        lines.push_back(line);
+    }
+    // A tick every 500 iterations, at most one early if this thread counted before, and the end
+    REQUIRE(lines.size() >= 4);
+    for (size_t i = 0; i + 1 < lines.size(); i++) {
+        REQUIRE(lines[i].find("\"event\":\"tick\"") != string::npos);
+        REQUIRE(field(lines[i], "iterations") <= field(lines[i + 1], "iterations"));
+    }
+    const string& end = lines.back();
+    REQUIRE(end.find("\"event\":\"end\"") != string::npos);
+    REQUIRE(field(end, "iterations") == after.iterations);
+    REQUIRE(field(end, "best") == errorScore(graph));
+    remove(path.c_str());
+}
+
+TEST_CASE("telemetry: the moves of the sweep threads are all counted") {
+    if (!telemetryCompiled()) return;
+    GeneratorOptions generator;
+    generator.width = 30;
+    generator.height = 30;
+    generator.seed = 2;
+    generator.infeasible = 0.2f;
+    const Board board = generateBoard(generator).board;
+    LahcOptions options;
+    options.maxIterations = 5000;
+    options.scoreMemorySize = 100;
+    // The moves are the color classes up to the budget, so their number does not depend on the threads
+    vector<uint64_t> moves;
+    for (int threads : {1, 4}) {
+        options.sweepThreads = threads;
+        Graph graph = fromBoard(board);
+        const TelemetryCounters before = telemetryTotal();
+        lahcFill(graph, options);
+        const TelemetryCounters after = telemetryTotal();
+        moves.push_back(after.iterations - before.iterations);
+        REQUIRE(after.accepted + after.rejected - before.accepted - before.rejected == moves.back());
+        REQUIRE(after.bestScore == errorScore(graph));
+    }
+    REQUIRE(moves[0] > 0);
+    REQUIRE(moves[0] == moves[1]);
+    // The workers are gone, only this thread is left
+    const string path = "build/unit/threads.jsonl";
+    remove(path.c_str());
+    REQUIRE(telemetryConfigure(path, 0));
+    telemetrySnapshot("check");
+    REQUIRE(telemetryConfigure("", 0));
+    ifstream in(path);
+    string line;
+    getline(in, line);
+    REQUIRE(field(line, "threads") == 1);
+    remove(path.c_str());
+}
@@ -0,0 +1,128 @@
+#include "tiles.hpp"
+#include "generator.hpp"
+#include "input.hpp"
+#include <catch.hpp>
+using namespace std;
+
+static GeneratedBoard generated(int width, int height, uint64_t seed) {
+    GeneratorOptions options;
+    options.width = width;
+    options.height = height;
+    options.seed = seed;
+    options.mask = 0.3f;
+    return generateBoard(options);
+}
+
+TEST_CASE("planeErrorScore: the same as errorScore of the graph") {
+    GeneratedBoard board = generated(50, 40, 3);
+    Graph graph = fromBoard(board.board);
+    REQUIRE(planeErrorScore(planeOf(viewOf(board.board))) == errorScore(graph));
+    armFromBoard(graph, board.solution);
+    REQUIRE(planeErrorScore(planeOf(viewOf(board.solution))) == errorScore(graph));
+    REQUIRE(errorScore(graph) == 0);
+}
+
+TEST_CASE("tiledFill: the plane holds the solution it scores") {
+    GeneratedBoard board = generated(90, 70, 5);
+    LahcOptions options;
+    options.seed = 2;
+    TileOptions tiles;
+    tiles.size = 32;
+    tiles.overlap = 6;
+    tiles.threads = 1;
+    TiledResult result = tiledFill(viewOf(board.board), options, tiles);
+    REQUIRE(result.tiles == 9);
+    REQUIRE(result.plane.width == 90);
+    REQUIRE(result.plane.height == 70);
+    REQUIRE(result.score == planeErrorScore(result.plane));
+    // The counts of the input are kept and the mines are only where the input has no count
+    const CellPlane input = planeOf(viewOf(board.board));
+    for (size_t i = 0; i < input.cells.size(); i++) {
+        if (input.cells[i] <= 9) REQUIRE(result.plane.cells[i] == input.cells[i]);
+    }
+    // The solution read back into the graph has the same error
+    const string text = planeText(result.plane);
+    Graph graph = fromBoard(board.board);
+    armFromBoard(graph, scanBoard(text.data(), text.size()).view);
+    REQUIRE(errorScore(graph) == result.score);
+    Graph empty = fromBoard(board.board);
+    REQUIRE(result.score < errorScore(empty));
+}
+
+TEST_CASE("tiledFill: the result does not depend on the thread count") {
+    GeneratedBoard board = generated(80, 60, 8);
+    LahcOptions options;
+    options.seed = 4;
+    TileOptions tiles;
+    tiles.size = 24;
+    tiles.threads = 1;
+    TiledResult serial = tiledFill(viewOf(board.board), options, tiles);
+    tiles.threads = 3;
+    TiledResult parallel = tiledFill(viewOf(board.board), options, tiles);
+    REQUIRE(serial.plane.cells == parallel.plane.cells);
+    REQUIRE(serial.score == parallel.score);
+    REQUIRE(serial.repairs == parallel.repairs);
+}
+
+// Violated counts at most distance cells away from a line between two tiles
+static int violatedNearSeams(const CellPlane& plane, int size, int distance) {
+    const auto nearSeam = [&](int at) {
+        const int offset = at % size;
+        return at >= size - distance && (offset < distance || offset >= size - distance);
+    };
+    int violated = 0;
+    for (int y = 0; y < plane.height; y++) {
+        for (int x = 0; x < plane.width; x++) {
+            const uint8_t cell = plane.cells[(size_t)y * plane.width + x];
+            if (cell > 9 || (!nearSeam(x) && !nearSeam(y))) continue;
+            int mines = 0;
+            for (int ny = max(0, y - 1); ny <= min(plane.height - 1, y + 1); ny++) {
+                for (int nx = max(0, x - 1); nx <= min(plane.width - 1, x + 1); nx++) {
+                    mines += plane.cells[(size_t)ny * plane.width + nx] == CELL_MINE;
+                }
+            }
+            violated += mines != cell;
+        }
+    }
+    return violated;
+}
+
+TEST_CASE("tiledFill: the repair fixes violated counts along the seams") {
+    GeneratedBoard board = generated(90, 70, 11);
+    LahcOptions options;
+    options.seed = 6;
+    TileOptions tiles;
+    tiles.size = 30;
+    // Without overlap the tiles do not see the counts across the seams, so the seams start out broken
+    tiles.overlap = 0;
+    tiles.threads = 1;
+    // A seam of 0 repairs nothing, the tiles get solved the same either way
+    tiles.seam = 0;
+    TiledResult unrepaired = tiledFill(viewOf(board.board), options, tiles);
+    REQUIRE(unrepaired.repairs == 0);
+    tiles.seam = 2;
+    TiledResult repaired = tiledFill(viewOf(board.board), options, tiles);
+    REQUIRE(repaired.repairs > 0);
+    const int before = violatedNearSeams(unrepaired.plane, tiles.size, tiles.seam);
+    const int after = violatedNearSeams(repaired.plane, tiles.size, tiles.seam);
+    REQUIRE(before > 0);
+    REQUIRE(after < before / 2);
+    REQUIRE(repaired.score < unrepaired.score);
+    // Away from the seams nothing changed
+    for (int y = 0; y < board.board.height; y++) {
+        for (int x = 0; x < board.board.width; x++) {
+            const int dx = min(x % tiles.size, tiles.size - x % tiles.size);
+            const int dy = min(y % tiles.size, tiles.size - y % tiles.size);
+            if (min(dx, dy) <= 2 * tiles.seam + 1) continue;
+            const size_t i = (size_t)y * board.board.width + x;
+            REQUIRE(repaired.plane.cells[i] == unrepaired.plane.cells[i]);
+        }
+    }
+}
+
+TEST_CASE("tiledFill: tiles too small for the seam throw") {
+    GeneratedBoard board = generated(20, 20, 1);
+    TileOptions tiles;
+    tiles.size = 10;
+    REQUIRE_THROWS_AS(tiledFill(viewOf(board.board), LahcOptions{}, tiles), invalid_argument);
+}